@@ -0,0 +1,68 @@
+#include "benchmark.hpp"
+#include "bench_types.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace wen::bench {
+
+namespace {
+
+// 生成一个带法线和纹理坐标的网格平面，每个 lod 一个 shape，分辨率逐级减半
+std::string generateGridObj(uint32_t resolution, uint32_t lod_count) {
+    auto directory = std::filesystem::temp_directory_path() / "wen_bench";
+    std::filesystem::create_directories(directory);
+    auto filepath = directory / ("grid_" + std::to_string(resolution) + "_" + std::to_string(lod_count) + ".obj");
+    if (std::filesystem::exists(filepath)) {
+        return filepath.string();
+    }
+
+    std::ofstream file(filepath, std::ios::out | std::ios::trunc);
+    uint32_t vertex_offset = 1;
+    for (uint32_t lod = 0; lod < lod_count; lod++) {
+        uint32_t n = std::max(resolution >> lod, 1u);
+        file << "o grid_lod" << lod << "\n";
+        for (uint32_t y = 0; y <= n; y++) {
+            for (uint32_t x = 0; x <= n; x++) {
+                float u = static_cast<float>(x) / n, v = static_cast<float>(y) / n;
+                file << "v " << u << " " << std::sin(u * 6.28318f) * std::cos(v * 6.28318f) * 0.1f << " " << v << "\n";
+                file << "vn 0 1 0\n";
+                file << "vt " << u << " " << v << "\n";
+            }
+        }
+        for (uint32_t y = 0; y < n; y++) {
+            for (uint32_t x = 0; x < n; x++) {
+                uint32_t i0 = vertex_offset + y * (n + 1) + x;
+                uint32_t i1 = i0 + 1, i2 = i0 + n + 1, i3 = i2 + 1;
+                file << "f " << i0 << "/" << i0 << "/" << i0 << " " << i2 << "/" << i2 << "/" << i2 << " " << i1 << "/" << i1 << "/" << i1 << "\n";
+                file << "f " << i1 << "/" << i1 << "/" << i1 << " " << i2 << "/" << i2 << "/" << i2 << " " << i3 << "/" << i3 << "/" << i3 << "\n";
+            }
+        }
+        vertex_offset += (n + 1) * (n + 1);
+    }
+    return filepath.string();
+}
+
+BenchmarkSetup importMesh(uint32_t resolution, uint32_t lod_count) {
+    return [resolution, lod_count]() -> BenchmarkFunction {
+        auto filepath = generateGridObj(resolution, lod_count);
+        return [filepath](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                MeshData data{};
+                bool result = AssetSystem::importMesh(filepath, {}, data);
+                doNotOptimize(result);
+                doNotOptimize(data);
+            }
+        };
+    };
+}
+
+}  // namespace
+
+void registerAssetBenchmarks(BenchmarkRunner& runner) {
+    // 导出 MeshData 后上传到 GPU 的部分需要设备，这里只测量 obj 解析和顶点去重
+    runner.add("asset/import_obj/64", importMesh(64, 1), 64 * 64 * 2);
+    runner.add("asset/import_obj/256_lods", importMesh(256, 4), 256 * 256 * 2);
+}
+
+}  // namespace wen::bench
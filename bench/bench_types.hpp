@@ -0,0 +1,139 @@
+#pragma once
+
+#include <wen.hpp>
+
+namespace wen::bench {
+
+// 序列化基准使用的数据
+struct BenchRecord {
+    REFLECT_CLASS("BenchRecord")
+    SERIALIZABLE_CLASS
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    uint32_t id = 0;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float weight = 0.0f;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    double value = 0.0;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    std::string name;
+
+    SERIALIZABLE_MEMBER
+    std::vector<float> samples;
+};
+
+// 没有填充字节的 POD，数组整体读写
+struct BenchPoint {
+    SERIALIZABLE_CLASS
+
+    SERIALIZABLE_MEMBER
+    glm::vec3 position{0, 0, 0};
+
+    SERIALIZABLE_MEMBER
+    float weight = 0.0f;
+};
+
+// 以下组件用于 Scene::tick 基准，每个组件只做少量计算，主要测量遍历和虚函数调用的开销
+class BenchMoverComponent : public Component {
+    REFLECT_CLASS("BenchMoverComponent")
+    SERIALIZABLE_CLASS
+
+public:
+    std::string getClassName() const override { return "BenchMoverComponent"; }
+    static std::string GetClassName() { return "BenchMoverComponent"; }
+
+    void onTick(float dt) override { position += velocity * speed * dt; }
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    glm::vec3 position{0, 0, 0};
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    glm::vec3 velocity{1, 0, 0};
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float speed = 1.0f;
+
+    REFLECT_FUNCTION()
+    void accelerate(float amount) { speed += amount; }
+
+    REFLECT_FUNCTION()
+    float getSpeed() const { return speed; }
+};
+
+class BenchSpinnerComponent : public Component {
+    REFLECT_CLASS("BenchSpinnerComponent")
+    SERIALIZABLE_CLASS
+
+public:
+    std::string getClassName() const override { return "BenchSpinnerComponent"; }
+    static std::string GetClassName() { return "BenchSpinnerComponent"; }
+
+    void onTick(float dt) override { rotation = glm::mod(rotation + angular_velocity * dt, 360.0f); }
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    glm::vec3 rotation{0, 0, 0};
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    glm::vec3 angular_velocity{0, 90, 0};
+};
+
+class BenchLifetimeComponent : public Component {
+    REFLECT_CLASS("BenchLifetimeComponent")
+    SERIALIZABLE_CLASS
+
+public:
+    std::string getClassName() const override { return "BenchLifetimeComponent"; }
+    static std::string GetClassName() { return "BenchLifetimeComponent"; }
+
+    void onTick(float dt) override {
+        age += dt;
+        if (age > lifetime) {
+            age = 0.0f;
+        }
+    }
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float age = 0.0f;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float lifetime = 10.0f;
+};
+
+class BenchHealthComponent : public Component {
+    REFLECT_CLASS("BenchHealthComponent")
+    SERIALIZABLE_CLASS
+
+public:
+    std::string getClassName() const override { return "BenchHealthComponent"; }
+    static std::string GetClassName() { return "BenchHealthComponent"; }
+
+    void onPostTick(float dt) override { health = std::min(health + regeneration * dt, max_health); }
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float health = 50.0f;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float max_health = 100.0f;
+
+    REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
+    float regeneration = 1.0f;
+};
+
+}  // namespace wen::bench
@@ -0,0 +1,230 @@
+#include "benchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace wen::bench {
+
+namespace {
+
+double elapsedNs(uint64_t iterations, const BenchmarkFunction& function) {
+    auto begin = std::chrono::steady_clock::now();
+    function(iterations);
+    auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+std::string formatNs(double ns) {
+    char buffer[32];
+    if (ns < 1e3) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ns", ns);
+    } else if (ns < 1e6) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+    } else if (ns < 1e9) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2f s", ns / 1e9);
+    }
+    return buffer;
+}
+
+// 只解析本程序 writeJson 输出的格式: 每个基准的 "name" 之后跟着它的 "median_ns"
+std::map<std::string, double> parseBaseline(const std::string& text) {
+    std::map<std::string, double> medians;
+    const std::string name_key = "\"name\":\"";
+    const std::string median_key = "\"median_ns\":";
+    size_t pos = 0;
+    while ((pos = text.find(name_key, pos)) != std::string::npos) {
+        pos += name_key.size();
+        size_t name_end = text.find('"', pos);
+        size_t object_end = text.find('}', pos);
+        if (name_end == std::string::npos || object_end == std::string::npos) {
+            break;
+        }
+        std::string name = text.substr(pos, name_end - pos);
+        size_t median = text.find(median_key, name_end);
+        if (median != std::string::npos && median < object_end) {
+            medians[name] = std::strtod(text.c_str() + median + median_key.size(), nullptr);
+        }
+        pos = object_end;
+    }
+    return medians;
+}
+
+}  // namespace
+
+void BenchmarkRunner::add(const std::string& name, BenchmarkSetup setup, uint64_t items_per_iteration) {
+    entries_.push_back({name, std::move(setup), std::max<uint64_t>(items_per_iteration, 1)});
+}
+
+bool BenchmarkRunner::isSelected(const std::string& name) const {
+    if (options_.filter.empty()) {
+        return true;
+    }
+    // 逗号分隔的多个子串，匹配任意一个即可
+    std::stringstream filters(options_.filter);
+    std::string filter;
+    while (std::getline(filters, filter, ',')) {
+        if (!filter.empty() && name.find(filter) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BenchmarkRunner::run() {
+    if (options_.list) {
+        for (const auto& entry : entries_) {
+            std::printf("%s\n", entry.name.c_str());
+        }
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> results;
+    std::printf("%-40s %12s %12s %12s %12s %10s %12s\n", "benchmark", "iterations", "min", "median", "max", "stddev", "per item");
+    for (const auto& entry : entries_) {
+        if (!isSelected(entry.name)) {
+            continue;
+        }
+        // 数据准备不计入耗时，被测函数析构时释放数据
+        BenchmarkResult result;
+        {
+            auto function = entry.setup();
+            result = measure(entry, function);
+        }
+        std::printf("%-40s %12llu %12s %12s %12s %9.1f%% %12s\n",
+            result.name.c_str(),
+            static_cast<unsigned long long>(result.iterations),
+            formatNs(result.min_ns).c_str(),
+            formatNs(result.median_ns).c_str(),
+            formatNs(result.max_ns).c_str(),
+            result.mean_ns > 0 ? result.stddev_ns / result.mean_ns * 100.0 : 0.0,
+            formatNs(result.median_ns / result.items_per_iteration).c_str());
+        std::fflush(stdout);
+        results.push_back(std::move(result));
+    }
+
+    if (!options_.json_filename.empty() && !writeJson(results)) {
+        return 2;
+    }
+    if (!options_.baseline_filename.empty()) {
+        return compareBaseline(results) ? 0 : 1;
+    }
+    return 0;
+}
+
+BenchmarkResult BenchmarkRunner::measure(const Entry& entry, const BenchmarkFunction& function) const {
+    // 逐步增加迭代次数，直到单次重复的耗时达到 min_time_ms
+    const double min_time_ns = options_.min_time_ms * 1e6;
+    uint64_t iterations = 1;
+    while (true) {
+        double ns = elapsedNs(iterations, function);
+        if (ns >= min_time_ns || iterations >= (1ull << 32)) {
+            break;
+        }
+        double scale = ns <= 0 ? 10.0 : std::clamp(min_time_ns * 1.2 / ns, 1.5, 10.0);
+        iterations = static_cast<uint64_t>(std::ceil(iterations * scale));
+    }
+
+    for (uint32_t i = 0; i < options_.warmup; i++) {
+        elapsedNs(iterations, function);
+    }
+
+    uint32_t repetitions = std::max(options_.repetitions, 1u);
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (uint32_t i = 0; i < repetitions; i++) {
+        samples.push_back(elapsedNs(iterations, function) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.name = entry.name;
+    result.iterations = iterations;
+    result.items_per_iteration = entry.items_per_iteration;
+    result.repetitions = repetitions;
+    result.min_ns = samples.front();
+    result.max_ns = samples.back();
+    result.median_ns = repetitions % 2 == 1
+                           ? samples[repetitions / 2]
+                           : (samples[repetitions / 2 - 1] + samples[repetitions / 2]) / 2.0;
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result.mean_ns = sum / repetitions;
+    double variance = 0;
+    for (double sample : samples) {
+        variance += (sample - result.mean_ns) * (sample - result.mean_ns);
+    }
+    result.stddev_ns = repetitions > 1 ? std::sqrt(variance / (repetitions - 1)) : 0.0;
+    return result;
+}
+
+bool BenchmarkRunner::writeJson(const std::vector<BenchmarkResult>& results) const {
+    std::ofstream file(options_.json_filename, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "failed to open benchmark output file: %s\n", options_.json_filename.c_str());
+        return false;
+    }
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    file << "{\"benchmarks\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        file << (i == 0 ? "" : ",") << "\n{\"name\":\"" << result.name << "\""
+             << ",\"iterations\":" << result.iterations
+             << ",\"items_per_iteration\":" << result.items_per_iteration
+             << ",\"repetitions\":" << result.repetitions
+             << ",\"min_ns\":" << result.min_ns
+             << ",\"median_ns\":" << result.median_ns
+             << ",\"mean_ns\":" << result.mean_ns
+             << ",\"max_ns\":" << result.max_ns
+             << ",\"stddev_ns\":" << result.stddev_ns << "}";
+    }
+    file << "\n]}\n";
+    std::printf("write %zu results to %s\n", results.size(), options_.json_filename.c_str());
+    return true;
+}
+
+bool BenchmarkRunner::compareBaseline(const std::vector<BenchmarkResult>& results) const {
+    std::ifstream file(options_.baseline_filename);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "failed to open baseline file: %s\n", options_.baseline_filename.c_str());
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    auto baseline = parseBaseline(text.str());
+
+    // 比较中位数，中位数受偶发的调度抖动影响最小
+    uint32_t regression_count = 0;
+    std::printf("\n%-40s %12s %12s %9s\n", "benchmark", "baseline", "current", "change");
+    for (const auto& result : results) {
+        auto iter = baseline.find(result.name);
+        if (iter == baseline.end() || iter->second <= 0) {
+            std::printf("%-40s %12s %12s %9s\n", result.name.c_str(), "-", formatNs(result.median_ns).c_str(), "new");
+            continue;
+        }
+        double change = result.median_ns / iter->second - 1.0;
+        bool regression = change > options_.threshold;
+        regression_count += regression ? 1 : 0;
+        std::printf("%-40s %12s %12s %+8.1f%%%s\n",
+            result.name.c_str(),
+            formatNs(iter->second).c_str(),
+            formatNs(result.median_ns).c_str(),
+            change * 100.0,
+            regression ? "  REGRESSION" : "");
+    }
+    if (regression_count > 0) {
+        std::printf("%u benchmarks regressed more than %.1f%%\n", regression_count, options_.threshold * 100.0);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace wen::bench
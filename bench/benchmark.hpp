@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace wen::bench {
+
+// 阻止编译器把基准循环中的计算优化掉
+template <typename T>
+inline void doNotOptimize(T&& value) {
+#if defined(_MSC_VER)
+    static const void* volatile sink;
+    sink = static_cast<const void*>(&value);
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+inline void clobberMemory() {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// 执行 iterations 次被测操作
+using BenchmarkFunction = std::function<void(uint64_t iterations)>;
+// 准备数据并返回被测函数，只有被选中的基准才会调用
+using BenchmarkSetup = std::function<BenchmarkFunction()>;
+
+struct BenchmarkOptions {
+    std::string filter;
+    uint32_t repetitions = 10;
+    uint32_t warmup = 2;
+    double min_time_ms = 50.0;
+    std::string json_filename;
+    std::string baseline_filename;
+    double threshold = 0.10;  // 中位数变慢超过该比例视为回退
+    bool list = false;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    uint64_t items_per_iteration = 1;
+    uint32_t repetitions = 0;
+    // 单次迭代耗时(ns)
+    double min_ns = 0;
+    double median_ns = 0;
+    double mean_ns = 0;
+    double max_ns = 0;
+    double stddev_ns = 0;
+};
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(const BenchmarkOptions& options) : options_(options) {}
+
+    // items_per_iteration 用于输出每个元素的耗时，例如一次 tick 更新的组件数
+    void add(const std::string& name, BenchmarkSetup setup, uint64_t items_per_iteration = 1);
+
+    // 返回进程退出码，与 baseline 对比出现回退时返回 1
+    int run();
+
+private:
+    struct Entry {
+        std::string name;
+        BenchmarkSetup setup;
+        uint64_t items_per_iteration;
+    };
+
+    bool isSelected(const std::string& name) const;
+    BenchmarkResult measure(const Entry& entry, const BenchmarkFunction& function) const;
+    bool writeJson(const std::vector<BenchmarkResult>& results) const;
+    bool compareBaseline(const std::vector<BenchmarkResult>& results) const;
+
+private:
+    BenchmarkOptions options_;
+    std::vector<Entry> entries_;
+};
+
+void registerSerializeBenchmarks(BenchmarkRunner& runner);
+void registerReflectBenchmarks(BenchmarkRunner& runner);
+void registerSceneBenchmarks(BenchmarkRunner& runner);
+void registerUUIDBenchmarks(BenchmarkRunner& runner);
+void registerAssetBenchmarks(BenchmarkRunner& runner);
+
+}  // namespace wen::bench
@@ -0,0 +1,93 @@
+#include "benchmark.hpp"
+#include <wen.hpp>
+#include <pch.hpp>
+#include <cstdio>
+
+using namespace wen;
+
+namespace {
+
+void printUsage() {
+    std::printf(
+        "wen_bench [options]\n"
+        "  --list                 list benchmarks and exit\n"
+        "  --filter a,b           only run benchmarks whose name contains any of the substrings\n"
+        "  --repetitions n        measured repetitions (default 10)\n"
+        "  --warmup n             warmup repetitions (default 2)\n"
+        "  --min-time ms          minimum time of a single repetition (default 50)\n"
+        "  --json filename        write results as json\n"
+        "  --baseline filename    compare medians with a previous json result\n"
+        "  --threshold percent    regression threshold for --baseline (default 10)\n");
+}
+
+// 只初始化不依赖窗口和 GPU 的系统
+void startupContext() {
+    global_context = new GlobalContext;
+    global_context->log_system.initialize(LogLevel::warn, LogLevel::warn);
+    global_context->profile_system.initialize();
+    global_context->job_system.initialize();
+    global_context->reflect_system.initialize();
+    global_context->game_object_uuid_allocator.initialize();
+    global_context->component_type_uuid_system.initialize();
+    global_context->scene_serializer.initialize();
+    global_context->reflect_system->registerReflectProperties();
+}
+
+void shutdownContext() {
+    global_context->scene_serializer.destroy();
+    global_context->component_type_uuid_system.destroy();
+    global_context->game_object_uuid_allocator.destroy();
+    global_context->reflect_system.destroy();
+    global_context->job_system.destroy();
+    global_context->profile_system.destroy();
+    global_context->log_system.destroy();
+    delete global_context;
+    global_context = nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bench::BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--list") {
+            options.list = true;
+        } else if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = std::stoul(argv[++i]);
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup = std::stoul(argv[++i]);
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time_ms = std::stod(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            options.json_filename = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            options.baseline_filename = argv[++i];
+        } else if (arg == "--threshold" && has_value) {
+            options.threshold = std::stod(argv[++i]) / 100.0;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    startupContext();
+
+    int result = 0;
+    {
+        bench::BenchmarkRunner runner(options);
+        bench::registerSerializeBenchmarks(runner);
+        bench::registerReflectBenchmarks(runner);
+        bench::registerSceneBenchmarks(runner);
+        bench::registerUUIDBenchmarks(runner);
+        bench::registerAssetBenchmarks(runner);
+        result = runner.run();
+    }
+
+    shutdownContext();
+
+    return result;
+}
@@ -0,0 +1,148 @@
+#include "benchmark.hpp"
+#include "bench_types.hpp"
+
+namespace wen::bench {
+
+namespace {
+
+// 直接创建的组件不属于任何 GameObject，只初始化 RTTI
+std::shared_ptr<BenchMoverComponent> createMover() {
+    auto mover = std::make_shared<BenchMoverComponent>();
+    mover->setupRTTI();
+    return mover;
+}
+
+}  // namespace
+
+void registerReflectBenchmarks(BenchmarkRunner& runner) {
+    runner.add("reflect/direct_access", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                mover->speed += 1.0f;
+                doNotOptimize(mover->speed);
+            }
+        };
+    });
+
+    runner.add("reflect/get_value_ref", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto& speed = mover->getValueRef<float>("speed");
+                speed += 1.0f;
+                doNotOptimize(speed);
+            }
+        };
+    });
+
+    runner.add("reflect/get_value_ref_handle", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            auto handle = mover->findMember("speed"_id);
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto& speed = mover->getValueRef<float>(handle);
+                speed += 1.0f;
+                doNotOptimize(speed);
+            }
+        };
+    });
+
+    runner.add("reflect/get_value_ref_typed", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            auto member = mover->findMember("speed"_id).getTyped<float>();
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto& speed = mover->getValueRef(member);
+                speed += 1.0f;
+                doNotOptimize(speed);
+            }
+        };
+    });
+
+    runner.add("reflect/copy_value_from", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            const auto& member = mover->getMember("position");
+            for (uint64_t i = 0; i < iterations; i++) {
+                glm::vec3 position(static_cast<float>(i));
+                member.copyValueFrom(mover.get(), &position);
+                clobberMemory();
+            }
+        };
+    });
+
+    runner.add("reflect/get_value_const", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                const auto& position = mover->getValueConst<glm::vec3>("position");
+                doNotOptimize(position);
+            }
+        };
+    });
+
+    runner.add("reflect/set_value", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                mover->setValue("speed", static_cast<float>(i));
+                clobberMemory();
+            }
+        };
+    });
+
+    runner.add("reflect/invoke", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                mover->invoke("accelerate", 1.0f);
+                clobberMemory();
+            }
+        };
+    });
+
+    runner.add("reflect/invoke_handle", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            auto handle = mover->findFunction("accelerate"_id);
+            for (uint64_t i = 0; i < iterations; i++) {
+                mover->invoke(handle, 1.0f);
+                clobberMemory();
+            }
+        };
+    });
+
+    runner.add("reflect/invoke_typed", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            auto function = mover->findFunction("accelerate"_id).getTyped<void(float)>();
+            for (uint64_t i = 0; i < iterations; i++) {
+                mover->invoke(function, 1.0f);
+                clobberMemory();
+            }
+        };
+    });
+
+    runner.add("reflect/invoke_ex", []() -> BenchmarkFunction {
+        auto mover = createMover();
+        return [mover](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                float speed = mover->invokeEx<float>("getSpeed");
+                doNotOptimize(speed);
+            }
+        };
+    });
+
+    runner.add("reflect/get_class", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            const std::string name = "BenchMoverComponent";
+            for (uint64_t i = 0; i < iterations; i++) {
+                const auto& descriptor = global_context->reflect_system->getClass(name);
+                doNotOptimize(descriptor);
+            }
+        };
+    });
+}
+
+}  // namespace wen::bench
@@ -0,0 +1,277 @@
+#include "benchmark.hpp"
+#include "bench_types.hpp"
+
+namespace wen::bench {
+
+namespace {
+
+constexpr uint32_t components_per_game_object = 4;
+
+std::shared_ptr<Scene> createScene(uint32_t component_count) {
+    auto scene = std::make_shared<Scene>("bench");
+    uint32_t game_object_count = component_count / components_per_game_object;
+    for (uint32_t i = 0; i < game_object_count; i++) {
+        auto* game_object = scene->createGameObject("bench");
+        auto* mover = game_object->addComponent<BenchMoverComponent>();
+        mover->velocity = {static_cast<float>(i % 7), 1, 0};
+        game_object->addComponent<BenchSpinnerComponent>();
+        game_object->addComponent<BenchLifetimeComponent>();
+        game_object->addComponent<BenchHealthComponent>();
+    }
+    scene->awake();
+    scene->start();
+    return scene;
+}
+
+BenchmarkSetup sceneTick(uint32_t component_count) {
+    return [component_count]() -> BenchmarkFunction {
+        auto scene = createScene(component_count);
+        // 与 SceneManager::tick 相同，tick 之后 postTick
+        return [scene](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                scene->tick(1.0f / 60.0f);
+                scene->postTick(1.0f / 60.0f);
+                clobberMemory();
+            }
+        };
+    };
+}
+
+// 与 tick 做相同的计算，但通过类型化查询直接访问连续存储的组件
+BenchmarkSetup sceneEach(uint32_t component_count) {
+    return [component_count]() -> BenchmarkFunction {
+        auto scene = createScene(component_count);
+        return [scene](uint64_t iterations) {
+            const float dt = 1.0f / 60.0f;
+            for (uint64_t i = 0; i < iterations; i++) {
+                scene->each<BenchMoverComponent>([dt](BenchMoverComponent& mover) {
+                    mover.position += mover.velocity * mover.speed * dt;
+                });
+                scene->each<BenchSpinnerComponent>([dt](BenchSpinnerComponent& spinner) {
+                    spinner.rotation = glm::mod(spinner.rotation + spinner.angular_velocity * dt, 360.0f);
+                });
+                scene->each<BenchLifetimeComponent, BenchHealthComponent>([dt](BenchLifetimeComponent& lifetime, BenchHealthComponent& health) {
+                    lifetime.age = lifetime.age + dt > lifetime.lifetime ? 0.0f : lifetime.age + dt;
+                    health.health = std::min(health.health + health.regeneration * dt, health.max_health);
+                });
+                clobberMemory();
+            }
+        };
+    };
+}
+
+class BenchMoverSystem final : public System {
+public:
+    BenchMoverSystem() : System("BenchMoverSystem") {}
+    void setupAccess(SystemAccess& access) override { access.write<BenchMoverComponent>(); }
+    void run(Scene& scene, float dt) override {
+        scene.parallelEach<BenchMoverComponent>([dt](BenchMoverComponent& mover) {
+            mover.position += mover.velocity * mover.speed * dt;
+        });
+    }
+};
+
+class BenchSpinnerSystem final : public System {
+public:
+    BenchSpinnerSystem() : System("BenchSpinnerSystem") {}
+    void setupAccess(SystemAccess& access) override { access.write<BenchSpinnerComponent>(); }
+    void run(Scene& scene, float dt) override {
+        scene.parallelEach<BenchSpinnerComponent>([dt](BenchSpinnerComponent& spinner) {
+            spinner.rotation = glm::mod(spinner.rotation + spinner.angular_velocity * dt, 360.0f);
+        });
+    }
+};
+
+class BenchLifetimeSystem final : public System {
+public:
+    BenchLifetimeSystem() : System("BenchLifetimeSystem") {}
+    void setupAccess(SystemAccess& access) override { access.write<BenchLifetimeComponent, BenchHealthComponent>(); }
+    void run(Scene& scene, float dt) override {
+        scene.parallelEach<BenchLifetimeComponent, BenchHealthComponent>([dt](BenchLifetimeComponent& lifetime, BenchHealthComponent& health) {
+            lifetime.age = lifetime.age + dt > lifetime.lifetime ? 0.0f : lifetime.age + dt;
+            health.health = std::min(health.health + health.regeneration * dt, health.max_health);
+        });
+    }
+};
+
+// 与 each 相同的计算拆成三个互不冲突的系统，由调度器并行运行
+// 测试组件没有 onFixedTick，系统注册在 fixedTick 阶段，避免与组件的 onTick 重复计算
+BenchmarkSetup sceneSystems(uint32_t component_count) {
+    return [component_count]() -> BenchmarkFunction {
+        auto scene = createScene(component_count);
+        scene->addSystem<BenchMoverSystem>(SystemPhase::eFixedTick);
+        scene->addSystem<BenchSpinnerSystem>(SystemPhase::eFixedTick);
+        scene->addSystem<BenchLifetimeSystem>(SystemPhase::eFixedTick);
+        return [scene](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                scene->fixedTick(1.0f / 60.0f);
+                clobberMemory();
+            }
+        };
+    };
+}
+
+// rig_depth 层深的骨骼链，每帧修改 dirty_ratio 比例的根节点
+BenchmarkSetup transformUpdate(uint32_t node_count, uint32_t rig_depth, float dirty_ratio) {
+    return [=]() -> BenchmarkFunction {
+        auto scene = std::make_shared<Scene>("bench");
+        auto roots = std::make_shared<std::vector<TransformComponent*>>();
+        TransformComponent* parent = nullptr;
+        for (uint32_t i = 0; i < node_count; i++) {
+            auto* game_object = scene->createGameObject("bench");
+            auto* transform = game_object->addComponent<TransformComponent>();
+            transform->setLocation({0.0f, 1.0f, 0.0f});
+            if (i % rig_depth == 0) {
+                roots->push_back(transform);
+            } else {
+                transform->setParent(parent);
+            }
+            parent = transform;
+        }
+        scene->updateTransforms();
+        auto dirty_count = std::max<uint32_t>(1, static_cast<uint32_t>(roots->size() * dirty_ratio));
+        return [scene, roots, dirty_count](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                for (uint32_t root = 0; root < dirty_count; root++) {
+                    auto* transform = (*roots)[(root + i * dirty_count) % roots->size()];
+                    transform->setRotation({0.0f, static_cast<float>(i % 360), 0.0f});
+                }
+                scene->updateTransforms();
+                doNotOptimize(scene->getTransformHierarchy().getChangedGameObjects().data());
+            }
+        };
+    };
+}
+
+// 在 200 x 200 x 200 的空间中随机放置 object_count 个包围盒，每帧移动 10% 后查询
+BenchmarkSetup spatialIndex(uint32_t object_count) {
+    return [=]() -> BenchmarkFunction {
+        auto index = std::make_shared<SpatialIndex>();
+        auto bounds = std::make_shared<std::vector<AABB>>();
+        uint32_t seed = 1;
+        auto random = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 200.0f - 100.0f;
+        };
+        for (uint32_t i = 0; i < object_count; i++) {
+            glm::vec3 center(random(), random(), random());
+            bounds->push_back({center - glm::vec3(0.5f), center + glm::vec3(0.5f)});
+            index->createProxy(bounds->back(), {i, 1});
+        }
+        auto frustum = Frustum::fromMatrix(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        return [index, bounds, frustum](uint64_t iterations) {
+            std::vector<SpatialIndex::NearestResult> nearest;
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto offset = glm::vec3(i % 2 == 0 ? 0.05f : -0.05f, 0.0f, 0.0f);
+                for (uint32_t proxy = static_cast<uint32_t>(i % 10); proxy < bounds->size(); proxy += 10) {
+                    auto& aabb = (*bounds)[proxy];
+                    aabb = {aabb.min + offset, aabb.max + offset};
+                    index->moveProxy(proxy, aabb);
+                }
+                index->refit();
+                uint32_t visible = 0;
+                index->queryFrustum(frustum, [&visible](GameObjectHandle) { visible++; });
+                nearest.clear();
+                index->queryNearest(glm::vec3(0.0f), 16, nearest);
+                doNotOptimize(visible);
+                doNotOptimize(nearest.data());
+            }
+        };
+    };
+}
+
+// 每个对象四个可以批量复制的组件
+BenchmarkSetup sceneSnapshot(uint32_t game_object_count, bool load, bool compress = false) {
+    return [=]() -> BenchmarkFunction {
+        auto scene = createScene(game_object_count * components_per_game_object);
+        auto path = (std::filesystem::temp_directory_path() / "wen_bench_scene.bin").string();
+        global_context->scene_serializer->save(*scene, path, compress);
+        if (!load) {
+            return [scene, path, compress](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    doNotOptimize(global_context->scene_serializer->save(*scene, path, compress));
+                }
+            };
+        }
+        return [path](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                Scene loaded("bench");
+                global_context->scene_serializer->load(loaded, path);
+                doNotOptimize(loaded.getGameObjectCount());
+            }
+        };
+    };
+}
+
+}  // namespace
+
+void registerSceneBenchmarks(BenchmarkRunner& runner) {
+    for (uint32_t component_count : {10000u, 100000u, 1000000u}) {
+        runner.add("scene/tick/" + std::to_string(component_count), sceneTick(component_count), component_count);
+        runner.add("scene/each/" + std::to_string(component_count), sceneEach(component_count), component_count);
+        runner.add("scene/systems/" + std::to_string(component_count), sceneSystems(component_count), component_count);
+    }
+
+    runner.add("scene/transform_update/100000/all", transformUpdate(100000, 8, 1.0f), 100000);
+    runner.add("scene/transform_update/100000/10%", transformUpdate(100000, 8, 0.1f), 100000);
+    runner.add("scene/spatial_index/100000", spatialIndex(100000), 100000);
+    runner.add("scene/snapshot_save/100000", sceneSnapshot(100000, false), 100000);
+    runner.add("scene/snapshot_load/100000", sceneSnapshot(100000, true), 100000);
+    runner.add("scene/snapshot_save/100000/compressed", sceneSnapshot(100000, false, true), 100000);
+    runner.add("scene/snapshot_load/100000/compressed", sceneSnapshot(100000, true, true), 100000);
+
+    runner.add("scene/create_destroy_game_object", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            Scene scene("bench");
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto* game_object = scene.createGameObject("bench");
+                game_object->addComponent<BenchMoverComponent>();
+                game_object->addComponent<BenchHealthComponent>();
+                doNotOptimize(game_object);
+            }
+        };
+    });
+
+    // 每帧生成一批 GameObject 并延迟销毁上一批，模拟子弹等短生命周期对象
+    runner.add("scene/spawn_despawn_game_object", []() -> BenchmarkFunction {
+        constexpr uint32_t batch_size = 1024;
+        auto scene = std::make_shared<Scene>("bench");
+        auto handles = std::make_shared<std::vector<GameObjectHandle>>();
+        handles->reserve(batch_size);
+        return [scene, handles](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                if (handles->size() == batch_size) {
+                    for (auto handle : *handles) {
+                        scene->destroyGameObject(handle);
+                    }
+                    scene->flushDestroyedGameObjects();
+                    handles->clear();
+                }
+                auto* game_object = scene->createGameObject("bench");
+                game_object->addComponent<BenchMoverComponent>();
+                handles->push_back(game_object->getHandle());
+            }
+        };
+    });
+
+    // 通过命令缓冲记录同样的创建，每 1024 个回放一次
+    runner.add("scene/command_buffer_spawn", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            constexpr uint32_t batch_size = 1024;
+            Scene scene("bench");
+            auto& command_buffer = scene.getCommandBuffer();
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto target = command_buffer.spawn("bench");
+                command_buffer.addComponent(target, new BenchMoverComponent);
+                command_buffer.addComponent(target, new BenchHealthComponent);
+                if ((i + 1) % batch_size == 0) {
+                    scene.playbackCommandBuffers();
+                }
+            }
+            scene.playbackCommandBuffers();
+            doNotOptimize(scene.getGameObjectCount());
+        };
+    });
+}
+
+}  // namespace wen::bench
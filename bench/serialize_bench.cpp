@@ -0,0 +1,254 @@
+#include "benchmark.hpp"
+#include "bench_types.hpp"
+#include "auto_generated/auto_generated.hpp"
+
+namespace wen::bench {
+
+namespace {
+
+constexpr uint32_t element_count = 1024;
+
+template <typename T>
+BenchmarkSetup roundTrip(std::function<T()> create) {
+    return [create]() -> BenchmarkFunction {
+        auto value = std::make_shared<T>(create());
+        return [value](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                SerializeStream serialize_stream;
+                serialize_stream << *value;
+                DeserializeStream deserialize_stream(std::move(serialize_stream));
+                T result;
+                deserialize_stream >> result;
+                doNotOptimize(result);
+            }
+        };
+    };
+}
+
+// 带标签的格式，读取时结构哈希相同，按位置读取
+template <typename T>
+BenchmarkSetup taggedRoundTrip(std::function<std::vector<T>()> create) {
+    return [create]() -> BenchmarkFunction {
+        auto values = std::make_shared<std::vector<T>>(create());
+        return [values](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                SerializeStream serialize_stream;
+                for (const auto& value : *values) {
+                    serializeTagged(serialize_stream, value);
+                }
+                DeserializeStream deserialize_stream(std::move(serialize_stream));
+                T result;
+                for (size_t j = 0; j < values->size(); j++) {
+                    deserializeTagged(deserialize_stream, result);
+                }
+                doNotOptimize(result);
+            }
+        };
+    };
+}
+
+std::string writeArrayFile() {
+    auto path = (std::filesystem::temp_directory_path() / "wen_bench_array.bin").string();
+    std::vector<glm::vec4> value(element_count * 64, glm::vec4(1.0f));
+    FileSink sink(path);
+    SerializeStream serialize_stream(sink);
+    writeAlignedArray(serialize_stream, std::span<const glm::vec4>(value));
+    return path;
+}
+
+}  // namespace
+
+void registerSerializeBenchmarks(BenchmarkRunner& runner) {
+    runner.add("serialize/arithmetic", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                SerializeStream serialize_stream;
+                for (uint32_t j = 0; j < element_count; j++) {
+                    serialize_stream << j << static_cast<double>(j);
+                }
+                DeserializeStream deserialize_stream(std::move(serialize_stream));
+                uint32_t u;
+                double d;
+                for (uint32_t j = 0; j < element_count; j++) {
+                    deserialize_stream >> u >> d;
+                    doNotOptimize(u);
+                    doNotOptimize(d);
+                }
+            }
+        };
+    }, element_count);
+
+    // 按块写入文件，后台线程预读的同时解码
+    runner.add("serialize/file_stream", []() -> BenchmarkFunction {
+        auto path = (std::filesystem::temp_directory_path() / "wen_bench_stream.bin").string();
+        return [path](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                {
+                    FileSink sink(path);
+                    SerializeStream serialize_stream(sink);
+                    for (uint32_t j = 0; j < element_count * 64; j++) {
+                        serialize_stream << j << static_cast<double>(j);
+                    }
+                }
+                AsyncFileSource source(path);
+                DeserializeStream deserialize_stream(source);
+                uint32_t u;
+                double d;
+                for (uint32_t j = 0; j < element_count * 64; j++) {
+                    deserialize_stream >> u >> d;
+                    doNotOptimize(u);
+                    doNotOptimize(d);
+                }
+            }
+        };
+    }, element_count * 64);
+
+    // 与 file_stream 相同的数据，按块压缩后写入，读取时在工作线程上并行解压
+    runner.add("serialize/compressed_file_stream", []() -> BenchmarkFunction {
+        auto path = (std::filesystem::temp_directory_path() / "wen_bench_compressed.bin").string();
+        return [path](uint64_t iterations) {
+            auto* job_system = global_context->job_system.getInstance();
+            for (uint64_t i = 0; i < iterations; i++) {
+                {
+                    // 帧头需要解压后的总大小
+                    SerializeStream serialize_stream;
+                    for (uint32_t j = 0; j < element_count * 64; j++) {
+                        serialize_stream << j << static_cast<double>(j);
+                    }
+                    auto data = serialize_stream.getData();
+                    FileSink file_sink(path);
+                    CompressSink compress_sink(file_sink, data.size(), CompressedFrame::default_block_size, job_system);
+                    compress_sink.write(data.data(), data.size());
+                }
+                AsyncFileSource file_source(path);
+                DecompressSource decompress_source(file_source, job_system);
+                DeserializeStream deserialize_stream(decompress_source);
+                uint32_t u;
+                double d;
+                for (uint32_t j = 0; j < element_count * 64; j++) {
+                    deserialize_stream >> u >> d;
+                    doNotOptimize(u);
+                    doNotOptimize(d);
+                }
+            }
+        };
+    }, element_count * 64);
+
+    runner.add("serialize/compress_block", []() -> BenchmarkFunction {
+        // 场景数据中常见的重复浮点数和递增的编号
+        auto raw = std::make_shared<std::vector<uint8_t>>();
+        SerializeStream serialize_stream;
+        for (uint32_t j = 0; j < element_count * 64; j++) {
+            serialize_stream << j << glm::vec3(static_cast<float>(j % 16));
+        }
+        auto data = serialize_stream.getData();
+        raw->assign(data.begin(), data.end());
+        return [raw](uint64_t iterations) {
+            std::vector<uint8_t> packed(raw->size());
+            std::vector<uint8_t> result(raw->size());
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto size = compressBlock(raw->data(), raw->size(), packed.data(), packed.size());
+                doNotOptimize(decompressBlock(packed.data(), size, result.data(), result.size()));
+            }
+        };
+    }, element_count * 64);
+
+    // 映射文件后原地读取对齐的数组，与复制到 vector 对比
+    runner.add("serialize/mapped_array", []() -> BenchmarkFunction {
+        auto path = writeArrayFile();
+        return [path](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                MappedDeserializeStream deserialize_stream(path);
+                auto view = deserialize_stream.readArray<glm::vec4>();
+                doNotOptimize(view[view.size() / 2]);
+            }
+        };
+    }, element_count * 64);
+
+    runner.add("serialize/copied_array", []() -> BenchmarkFunction {
+        auto path = writeArrayFile();
+        return [path](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                FileSource source(path);
+                DeserializeStream deserialize_stream(source);
+                std::vector<glm::vec4> value;
+                readAlignedArray(deserialize_stream, value);
+                doNotOptimize(value[value.size() / 2]);
+            }
+        };
+    }, element_count * 64);
+
+    runner.add("serialize/vector_float", roundTrip<std::vector<float>>([]() {
+        std::vector<float> value(element_count * 16);
+        for (size_t i = 0; i < value.size(); i++) {
+            value[i] = static_cast<float>(i) * 0.5f;
+        }
+        return value;
+    }), element_count * 16);
+
+    runner.add("serialize/vector_vec3", roundTrip<std::vector<glm::vec3>>([]() {
+        std::vector<glm::vec3> value(element_count * 16);
+        for (size_t i = 0; i < value.size(); i++) {
+            value[i] = glm::vec3(static_cast<float>(i));
+        }
+        return value;
+    }), element_count * 16);
+
+    runner.add("serialize/vector_pod_records", roundTrip<std::vector<BenchPoint>>([]() {
+        static_assert(is_bulk_serializable_v<BenchPoint>);
+        std::vector<BenchPoint> value(element_count * 16);
+        for (size_t i = 0; i < value.size(); i++) {
+            value[i].position = glm::vec3(static_cast<float>(i));
+            value[i].weight = static_cast<float>(i) * 0.25f;
+        }
+        return value;
+    }), element_count * 16);
+
+    runner.add("serialize/tagged_records", taggedRoundTrip<BenchRecord>([]() {
+        std::vector<BenchRecord> value(element_count);
+        for (uint32_t i = 0; i < element_count; i++) {
+            value[i].id = i;
+            value[i].name = "record_" + std::to_string(i);
+            value[i].samples.assign(8, static_cast<float>(i));
+        }
+        return value;
+    }), element_count);
+
+    runner.add("serialize/tagged_pod_records", taggedRoundTrip<BenchPoint>([]() {
+        std::vector<BenchPoint> value(element_count);
+        for (uint32_t i = 0; i < element_count; i++) {
+            value[i].position = glm::vec3(static_cast<float>(i));
+        }
+        return value;
+    }), element_count);
+
+    runner.add("serialize/vector_string", roundTrip<std::vector<std::string>>([]() {
+        std::vector<std::string> value(element_count);
+        for (size_t i = 0; i < value.size(); i++) {
+            value[i] = "game_object_" + std::to_string(i);
+        }
+        return value;
+    }), element_count);
+
+    runner.add("serialize/map", roundTrip<std::map<uint32_t, std::string>>([]() {
+        std::map<uint32_t, std::string> value;
+        for (uint32_t i = 0; i < element_count; i++) {
+            value.insert({i, "component_" + std::to_string(i)});
+        }
+        return value;
+    }), element_count);
+
+    runner.add("serialize/reflected_records", roundTrip<std::vector<BenchRecord>>([]() {
+        std::vector<BenchRecord> value(element_count);
+        for (uint32_t i = 0; i < element_count; i++) {
+            value[i].id = i;
+            value[i].weight = static_cast<float>(i) * 0.25f;
+            value[i].value = static_cast<double>(i) * 1.5;
+            value[i].name = "record_" + std::to_string(i);
+            value[i].samples.assign(8, static_cast<float>(i));
+        }
+        return value;
+    }), element_count);
+}
+
+}  // namespace wen::bench
@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+#include "bench_types.hpp"
+
+namespace wen::bench {
+
+void registerUUIDBenchmarks(BenchmarkRunner& runner) {
+    runner.add("uuid/component_type_get", []() -> BenchmarkFunction {
+        // 名字提前构造好，只测量查找本身
+        auto names = std::make_shared<std::vector<std::string>>(std::vector<std::string>{
+            TransformComponent::GetClassName(),
+            MeshComponent::GetClassName(),
+            CameraComponent::GetClassName(),
+            CameraControllerComponent::GetClassName(),
+            BenchMoverComponent::GetClassName(),
+            BenchSpinnerComponent::GetClassName(),
+            BenchLifetimeComponent::GetClassName(),
+            BenchHealthComponent::GetClassName(),
+        });
+        return [names](uint64_t iterations) {
+            auto& uuid_system = *global_context->component_type_uuid_system;
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto uuid = uuid_system.get((*names)[i % names->size()]);
+                doNotOptimize(uuid);
+            }
+        };
+    });
+
+    runner.add("uuid/component_type_get_typed", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto uuid = ComponentTypeUUIDSystem::get<BenchHealthComponent>();
+                doNotOptimize(uuid);
+            }
+        };
+    });
+
+    runner.add("uuid/query_component", []() -> BenchmarkFunction {
+        auto scene = std::make_shared<Scene>("bench");
+        auto* game_object = scene->createGameObject("bench");
+        game_object->addComponent<BenchMoverComponent>();
+        game_object->addComponent<BenchSpinnerComponent>();
+        game_object->addComponent<BenchLifetimeComponent>();
+        game_object->addComponent<BenchHealthComponent>();
+        return [scene, game_object](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto* health = game_object->queryComponent<BenchHealthComponent>();
+                doNotOptimize(health);
+            }
+        };
+    });
+
+    runner.add("uuid/query_component_by_name", []() -> BenchmarkFunction {
+        auto scene = std::make_shared<Scene>("bench");
+        auto* game_object = scene->createGameObject("bench");
+        game_object->addComponent<BenchMoverComponent>();
+        game_object->addComponent<BenchHealthComponent>();
+        auto name = std::make_shared<std::string>(BenchHealthComponent::GetClassName());
+        return [scene, game_object, name](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto* health = game_object->queryComponent(*name);
+                doNotOptimize(health);
+            }
+        };
+    });
+
+    runner.add("uuid/game_object_allocate", []() -> BenchmarkFunction {
+        return [](uint64_t iterations) {
+            auto& allocator = *global_context->game_object_uuid_allocator;
+            for (uint64_t i = 0; i < iterations; i++) {
+                auto uuid = allocator.allocate();
+                doNotOptimize(uuid);
+            }
+        };
+    });
+}
+
+}  // namespace wen::bench
@@ -13,7 +13,8 @@ class RemoveComments:
         self.line_number = 0
 
         lines = f.readlines()
-        self.need_parse = "REFLECT_CLASS" in "".join(lines)
+        text = "".join(lines)
+        self.need_parse = "REFLECT_CLASS" in text or "SERIALIZABLE_CLASS" in text
         if not self.need_parse:
             return
 
@@ -58,6 +59,8 @@ class ClassInfo:
         self.serializable = False
         self.serialize_parent = False
         self.serializable_members = []
+        # 与 serializable_members 一一对应的成员类型，用于带标签格式的字段 ID
+        self.serializable_member_types = []
 
 
 class ClassContext:
@@ -166,6 +169,16 @@ def extract_member_name(line):
     return identifiers[-1]
 
 
+def extract_member_type(line, member_name):
+    # 成员名字之前的声明，去掉多余的空白
+    match = re.search(r"^(.*?)\b%s\b\s*(?:[;{=\[]|$)" % re.escape(member_name), line.strip())
+    if not match:
+        return ""
+    member_type = re.sub(r"\b(?:mutable|static|inline)\b", " ", match.group(1))
+    member_type = re.sub(r"\s+", " ", member_type).strip()
+    return re.sub(r"\s*([<>,:*&])\s*", r"\1", member_type)
+
+
 def extract_function_name(line):
     match = re.search(r"([A-Za-z_]\w*)\s*\(", line)
     if not match:
@@ -273,6 +286,7 @@ def parse_header(path, include_root):
                 member_name = extract_member_name(candidate_line)
                 if member_name:
                     context.info.serializable_members.append(member_name)
+                    context.info.serializable_member_types.append(extract_member_type(candidate_line, member_name))
                 else:
                     context.pending_serializable_member = True
 
@@ -324,6 +338,7 @@ def parse_header(path, include_root):
                     member_name = extract_member_name(raw_line)
                     if member_name:
                         context.info.serializable_members.append(member_name)
+                        context.info.serializable_member_types.append(extract_member_type(raw_line, member_name))
                         context.pending_serializable_member = False
 
         depth += open_count - close_count
@@ -373,6 +388,165 @@ def collect_unique_includes(
     return includes
 
 
+def generate_pack_functions(cls, lines):
+    # 所有序列化成员都可以平凡复制时，按成员依次复制到连续的内存中，用于场景快照的批量读写
+    name = cls.qualified_name
+    lines.append("\n")
+    if cls.serialize_parent and cls.base_classes:
+        lines.append("    static constexpr bool packable = false;\n")
+        return
+    members = cls.serializable_members
+    if members:
+        conditions = " && ".join(
+            f"std::is_trivially_copyable_v<decltype({name}::{member})>" for member in members
+        )
+        sizes = " + ".join(f"sizeof({name}::{member})" for member in members)
+    else:
+        conditions = "true"
+        sizes = "0"
+    lines.append(f"    static constexpr bool packable = {conditions};\n")
+    lines.append(f"    static constexpr size_t packed_size = {sizes};\n")
+    # 成员都可以整体读写并且占满整个对象时，对象的字节与逐个成员写入的结果相同，数组可以整体复制
+    # 成员只检查 BulkSerializable，不引用其他生成的类的 SerializeTraits，与生成的顺序无关
+    if members:
+        bulk_conditions = " && ".join(
+            f"BulkSerializable<decltype({name}::{member})>::value" for member in members
+        )
+        lines.append(
+            f"    static constexpr bool bulk_serializable = std::is_trivially_copyable_v<{name}> && "
+            f"std::is_standard_layout_v<{name}> && {bulk_conditions} && packed_size == sizeof({name});\n\n"
+        )
+    else:
+        lines.append("\n")
+    lines.append(f"    static void pack(uint8_t* dst, const {name}& value) {{\n")
+    for member in members:
+        lines.append(f"        std::memcpy(dst, static_cast<const void*>(&value.{member}), sizeof(value.{member}));\n")
+        lines.append(f"        dst += sizeof(value.{member});\n")
+    lines.append("    }\n\n")
+    lines.append(f"    static void unpack(const uint8_t* src, {name}& value) {{\n")
+    for member in members:
+        lines.append(f"        std::memcpy(static_cast<void*>(&value.{member}), src, sizeof(value.{member}));\n")
+        lines.append(f"        src += sizeof(value.{member});\n")
+    lines.append("        notifyPropertyChanged(value);\n")
+    lines.append("    }\n")
+
+
+def get_serialize_parents(cls):
+    return cls.base_classes if cls.serialize_parent else []
+
+
+def sort_serializable_classes(classes):
+    # 父类和成员类型中用到的类先生成，外层的类的结构哈希可以直接引用它们的 schema_hash
+    classes = [cls for cls in classes if cls.serializable]
+    by_name = {}
+    for cls in classes:
+        by_name.setdefault(cls.name, cls)
+        by_name.setdefault(cls.qualified_name, cls)
+
+    def dependencies(cls):
+        names = list(get_serialize_parents(cls))
+        for member_type in cls.serializable_member_types:
+            names.extend(re.findall(r"[A-Za-z_]\w*(?:::[A-Za-z_]\w*)*", member_type))
+        result = []
+        for name in names:
+            dependency = by_name.get(name) or by_name.get(name.split("::")[-1])
+            if dependency is not None and dependency is not cls:
+                result.append(dependency)
+        return result
+
+    ordered = []
+    visited = set()
+
+    def visit(cls):
+        if id(cls) in visited:
+            return
+        visited.add(id(cls))
+        for dependency in dependencies(cls):
+            visit(dependency)
+        ordered.append(cls)
+
+    for cls in classes:
+        visit(cls)
+    return ordered
+
+
+def generate_tagged_functions(cls, lines):
+    # 带标签的格式见 core/serialize/tagged.hpp
+    name = cls.qualified_name
+    parents = get_serialize_parents(cls)
+    members = list(zip(cls.serializable_member_types, cls.serializable_members))
+    has_bulk = bool(members) and not parents
+    schema = f"{name}({','.join(parents)}){{{';'.join(f'{t} {m}' for t, m in members)}}}"
+    member_hashes = ", ".join(f"SchemaHash<decltype({name}::{m})>::value" for _, m in members)
+    # 父类是嵌套的块，自己处理结构变化；成员的字段 ID 包含成员类型的结构哈希，成员的类改变时旧的数据按不认识的字段跳过
+    field_ids = [hash_name(f"parent {base}") for base in parents]
+    field_ids += [
+        f"combineSchemaHash({hash_name(f'{t} {m}')}, {{SchemaHash<decltype({name}::{m})>::value}})" for t, m in members
+    ]
+    parent_fields = list(enumerate(parents))
+    member_fields = [(len(parents) + i, m) for i, (_, m) in enumerate(members)]
+
+    lines.append("\n")
+    lines.append(f"    static constexpr uint64_t schema_hash = combineSchemaHash({hash_name(schema)}, {{{member_hashes}}});\n")
+    if field_ids:
+        lines.append("    static constexpr NameID field_ids[] = {\n")
+        for field_id in field_ids:
+            lines.append(f"        {field_id},\n")
+        lines.append("    };\n")
+    lines.append("\n")
+
+    lines.append(f"    static void serializeTagged(SerializeStream& stream, const {name}& value) {{\n")
+    if has_bulk:
+        lines.append("        if constexpr (bulk_serializable) {\n")
+        fields = ", ".join(f"{{field_ids[{i}], sizeof({name}::{m})}}" for i, m in member_fields)
+        lines.append(f"            static constexpr TaggedField fields[] = {{{fields}}};\n")
+        lines.append("            TaggedWriter::writeBulk(stream, schema_hash, fields, &value, sizeof(value));\n")
+        lines.append("            return;\n")
+        lines.append("        }\n")
+    lines.append("        TaggedWriter writer(stream, schema_hash);\n")
+    for i, base in parent_fields:
+        lines.append(f"        writer.parent(field_ids[{i}], static_cast<const {base}&>(value));\n")
+    for i, m in member_fields:
+        lines.append(f"        writer.field(field_ids[{i}], value.{m});\n")
+    lines.append("        writer.finish();\n")
+    lines.append("    }\n\n")
+
+    lines.append(f"    static void deserializeTagged(DeserializeStream& stream, {name}& value) {{\n")
+    lines.append("        TaggedReader reader(stream);\n")
+    lines.append("        if (reader.matches(schema_hash)) {\n")
+    if has_bulk:
+        lines.append("            if constexpr (bulk_serializable) {\n")
+        lines.append("                stream.read(static_cast<void*>(&value), sizeof(value));\n")
+        lines.append("            } else {\n")
+        for _, m in member_fields:
+            lines.append(f"                stream >> value.{m};\n")
+        lines.append("            }\n")
+    else:
+        for _, base in parent_fields:
+            lines.append(f"            SerializeTraits<{base}>::deserializeTagged(stream, static_cast<{base}&>(value));\n")
+        for _, m in member_fields:
+            lines.append(f"            stream >> value.{m};\n")
+    lines.append("        } else {\n")
+    lines.append("            while (reader.nextField()) {\n")
+    lines.append("                switch (reader.getFieldID()) {\n")
+    for i, base in parent_fields:
+        lines.append(f"                    case field_ids[{i}]:\n")
+        lines.append(f"                        SerializeTraits<{base}>::deserializeTagged(stream, static_cast<{base}&>(value));\n")
+        lines.append("                        break;\n")
+    for i, m in member_fields:
+        lines.append(f"                    case field_ids[{i}]:\n")
+        lines.append(f"                        stream >> value.{m};\n")
+        lines.append("                        break;\n")
+    lines.append("                    default:\n")
+    lines.append("                        break;\n")
+    lines.append("                }\n")
+    lines.append("            }\n")
+    lines.append("        }\n")
+    lines.append("        reader.finish();\n")
+    lines.append("        notifyPropertyChanged(value);\n")
+    lines.append("    }\n")
+
+
 def generate_serialize_hpp(classes, include_roots, output_path):
     includes = collect_unique_includes(classes, include_roots, use_serialize=True)
 
@@ -381,15 +555,15 @@ def generate_serialize_hpp(classes, include_roots, output_path):
     lines.append("// This file is auto-generated by engine/parser/parser.py.\n")
     lines.append("// Do not edit manually.\n\n")
     lines.append('#include "core/serialize/stream.hpp"\n')
+    lines.append('#include "core/serialize/tagged.hpp"\n')
+    lines.append("#include <cstring>\n")
     for inc in includes:
         lines.append(f'#include "{inc}"\n')
     lines.append("\n")
     lines.append("using namespace wen;\n\n")
+    lines.append("namespace wen {\n\n")
 
-    for cls in classes:
-        if not cls.serializable:
-            continue
-
+    for cls in sort_serializable_classes(classes):
         lines.append("template <>\n")
         lines.append(f"struct SerializeTraits<{cls.qualified_name}> {{\n")
         lines.append(
@@ -405,19 +579,82 @@ def generate_serialize_hpp(classes, include_roots, output_path):
         lines.append(
             f"    static void deserialize(DeserializeStream& stream, {cls.qualified_name}& value) {{\n"
         )
-        for member_name in reversed(cls.serializable_members):
-            lines.append(f"        stream >> value.{member_name};\n")
         if cls.serialize_parent and cls.base_classes:
-            for base in reversed(cls.base_classes):
+            for base in cls.base_classes:
                 lines.append(f"        stream >> static_cast<{base}&>(value);\n")
+        for member_name in cls.serializable_members:
+            lines.append(f"        stream >> value.{member_name};\n")
+        lines.append("        notifyPropertyChanged(value);\n")
         lines.append("    }\n")
-        lines.append("};\n")
+        generate_pack_functions(cls, lines)
+        generate_tagged_functions(cls, lines)
+        lines.append("};\n\n")
+
+    lines.append("}  // namespace wen\n")
 
     os.makedirs(os.path.dirname(output_path), exist_ok=True)
     with open(output_path, "w", encoding="utf-8") as f:
         f.writelines(lines)
 
 
+def hash_value(name):
+    # 与 core/reflect/name_hash.hpp 中的 hashName 相同的 64 位 FNV-1a
+    value = 0xCBF29CE484222325
+    for byte in name.encode("utf-8"):
+        value ^= byte
+        value = (value * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def hash_name(name):
+    return f"0x{hash_value(name):016x}ull"
+
+
+def generate_name_index(names, owner):
+    # 按名字哈希排序，运行时二分查找，重名或者哈希冲突时停止生成
+    entries = sorted((hash_value(name), i, name) for i, name in enumerate(names))
+    for prev, cur in zip(entries, entries[1:]):
+        if prev[0] == cur[0]:
+            sys.exit(f"parser.py: {prev[2]} and {cur[2]} in {owner} have the same name hash")
+    return ", ".join(f"{{0x{value:016x}ull, {i}}}" for value, i, _ in entries)
+
+
+def generate_class_tables(cls, index, lines):
+    # 只读常量表，在函数内定义以便访问 ALLOW_PRIVATE_REFLECT 的私有成员
+    name = cls.qualified_name
+    members = "{}"
+    member_index = "{}"
+    functions = "{}"
+    function_index = "{}"
+    lines.append(f"    // {name}\n")
+    if cls.members:
+        lines.append(f"    static constexpr Member members_{index}[] = {{\n")
+        for reflect_name, member_name in cls.members:
+            lines.append(
+                f'        Member::create<decltype({name}::{member_name})>("{reflect_name}", {hash_name(reflect_name)}, offsetof({name}, {member_name})),\n'
+            )
+        lines.append("    };\n")
+        entries = generate_name_index([m[0] for m in cls.members], cls.reflect_name)
+        lines.append(f"    static constexpr NameIndex member_index_{index}[] = {{{entries}}};\n")
+        members = f"members_{index}"
+        member_index = f"member_index_{index}"
+    if cls.functions:
+        lines.append(f"    static constexpr Function functions_{index}[] = {{\n")
+        for reflect_name, function_name in cls.functions:
+            lines.append(
+                f'        Function::create<&{name}::{function_name}>("{reflect_name}", {hash_name(reflect_name)}),\n'
+            )
+        lines.append("    };\n")
+        entries = generate_name_index([f[0] for f in cls.functions], cls.reflect_name)
+        lines.append(f"    static constexpr NameIndex function_index_{index}[] = {{{entries}}};\n")
+        functions = f"functions_{index}"
+        function_index = f"function_index_{index}"
+    lines.append(
+        f'    static constexpr ClassDescriptor class_{index}("{cls.reflect_name}", {hash_name(cls.reflect_name)}, '
+        f"{members}, {member_index}, {functions}, {function_index});\n\n"
+    )
+
+
 def generate_reflect_cpp(classes, include_roots, output_path):
     includes = collect_unique_includes(classes, include_roots, use_reflect=True)
 
@@ -426,9 +663,14 @@ def generate_reflect_cpp(classes, include_roots, output_path):
     lines.append("// Do not edit manually.\n\n")
     lines.append('#include "engine/global_context.hpp"\n')
     lines.append('#include "core/reflect/reflect_system.hpp"\n')
+    lines.append('#include "auto_generated.hpp"\n')
     for inc in includes:
         lines.append(f'#include "{inc}"\n')
-    lines.append("\n")
+    lines.append("#include <cstddef>\n\n")
+    lines.append("// 带有虚函数的组件不是标准布局，编译器仍然支持对它们使用 offsetof\n")
+    lines.append("#if defined(__GNUC__)\n")
+    lines.append('#pragma GCC diagnostic ignored "-Winvalid-offsetof"\n')
+    lines.append("#endif\n\n")
     lines.append("void Parser() {\n")
     lines.append("    using namespace wen;\n")
     lines.append("    if (global_context == nullptr) {\n")
@@ -436,25 +678,28 @@ def generate_reflect_cpp(classes, include_roots, output_path):
     lines.append("    }\n")
     lines.append("    if (global_context->reflect_system.getInstance() == nullptr) {\n")
     lines.append("        return;\n")
-    lines.append("    }\n")
-    lines.append("    auto& reflect_system = *global_context->reflect_system;\n\n")
-
-    for cls in classes:
-        if cls.reflect_name is None:
-            continue
-        lines.append("    {\n")
-        lines.append(
-            f'        auto class_builder = reflect_system.addClass<{cls.qualified_name}>("{cls.reflect_name}");\n'
-        )
-        for reflect_name, member_name in cls.members:
+    lines.append("    }\n\n")
+
+    reflect_classes = [cls for cls in classes if cls.reflect_name is not None]
+    for i, cls in enumerate(reflect_classes):
+        generate_class_tables(cls, i, lines)
+    if reflect_classes:
+        descriptors = ", ".join(f"&class_{i}" for i in range(len(reflect_classes)))
+        entries = generate_name_index([cls.reflect_name for cls in reflect_classes], "reflected classes")
+        lines.append(f"    static constexpr const ClassDescriptor* classes[] = {{{descriptors}}};\n")
+        lines.append(f"    static constexpr NameIndex class_index[] = {{{entries}}};\n")
+        lines.append("    global_context->reflect_system->publish(classes, class_index);\n\n")
+
+    # 不是组件或者不能默认构造的类型在 registerComponent 中被忽略
+    serializable_classes = [cls for cls in classes if cls.serializable]
+    if serializable_classes:
+        lines.append("    if (global_context->scene_serializer.getInstance() != nullptr) {\n")
+        lines.append("        auto& scene_serializer = *global_context->scene_serializer;\n")
+        for cls in serializable_classes:
             lines.append(
-                f'        class_builder.addMember("{reflect_name}", &{cls.qualified_name}::{member_name});\n'
+                f"        scene_serializer.registerComponent<{cls.qualified_name}>();\n"
             )
-        for reflect_name, function_name in cls.functions:
-            lines.append(
-                f'        class_builder.addFunction("{reflect_name}", &{cls.qualified_name}::{function_name});\n'
-            )
-        lines.append("    }\n\n")
+        lines.append("    }\n")
 
     lines.append("}\n")
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace wen {
+
+// 单生产者单消费者无锁环形队列，Capacity 个元素
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity > 0);
+
+public:
+    // 仅生产者线程调用
+    bool tryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        buffer_[tail % Capacity] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+        return true;
+    }
+
+    // 仅消费者线程调用
+    bool tryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) {
+            return false;
+        }
+        value = buffer_[head % Capacity];
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return true;
+    }
+
+    // 队列满时阻塞等待消费者取走元素
+    void push(const T& value) {
+        while (!tryPush(value)) {
+            head_.wait(tail_.load(std::memory_order_relaxed) - Capacity, std::memory_order_acquire);
+        }
+    }
+
+    // 队列空时阻塞等待生产者放入元素
+    T pop() {
+        T value;
+        while (!tryPop(value)) {
+            tail_.wait(head_.load(std::memory_order_relaxed), std::memory_order_acquire);
+        }
+        return value;
+    }
+
+private:
+    std::array<T, Capacity> buffer_{};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace wen
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/base/singleton.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wen {
+
+// 任务计数器，所有关联的任务执行完毕后归零
+class JobCounter {
+    friend class JobSystem;
+
+public:
+    bool finished() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    std::atomic<uint32_t> pending_{0};
+};
+
+using JobHandle = std::shared_ptr<JobCounter>;
+
+class JobSystem final {
+    friend class Singleton<JobSystem>;
+    JobSystem(uint32_t worker_count = 0);
+    ~JobSystem();
+
+public:
+    // 提交一个任务，可传入已有的 handle 将多个任务归为一组
+    JobHandle schedule(std::function<void()> job, JobHandle handle = nullptr);
+    // 等待期间当前线程会参与执行任务，可以在任务内部调用
+    void wait(const JobHandle& handle);
+
+    // 将 [begin, end) 按 grain_size 切分，job(batch_begin, batch_end) 在工作线程上执行
+    template <typename Index, typename Func>
+    void parallelFor(Index begin, Index end, Index grain_size, Func&& job) {
+        if (begin >= end) {
+            return;
+        }
+        grain_size = std::max<Index>(grain_size, 1);
+        if (end - begin <= grain_size || workers_.empty()) {
+            job(begin, end);
+            return;
+        }
+        auto handle = std::make_shared<JobCounter>();
+        Index batch_begin = begin;
+        while (end - batch_begin > grain_size) {
+            Index batch_end = batch_begin + grain_size;
+            schedule([&job, batch_begin, batch_end]() { job(batch_begin, batch_end); }, handle);
+            batch_begin = batch_end;
+        }
+        // 最后一批由调用线程执行
+        job(batch_begin, end);
+        wait(handle);
+    }
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+    // 当前线程的工作线程下标，非工作线程返回 -1
+    static int32_t getCurrentWorkerIndex();
+
+private:
+    struct Job {
+        std::function<void()> task;
+        JobHandle handle;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(uint32_t index);
+    bool tryExecute(uint32_t index);
+    bool popJob(uint32_t index, Job& job);
+    bool stealJob(uint32_t index, Job& job);
+    void execute(Job& job);
+
+private:
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::atomic<uint32_t> next_queue_{0};
+    std::atomic<uint32_t> queued_job_count_{0};
+    std::atomic<bool> running_{true};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+};
+
+}  // namespace wen
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "core/base/singleton.hpp"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace wen {
+
+enum class ProfileEventType : uint8_t {
+    eScope,
+    eCounter,
+};
+
+// 一次作用域计时或计数器采样，name 必须是静态字符串或 ProfileSystem::internName 的返回值
+struct ProfileEvent {
+    const char* name;
+    uint64_t path;    // 从根到当前作用域的路径哈希
+    uint64_t parent;  // 父作用域的路径哈希，根为 0
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    uint32_t depth;
+    ProfileEventType type;
+    double value;     // 计数器的值
+};
+
+// 每个线程一个环形缓冲区，本线程写入，ProfileSystem 在收集时读取，无锁
+// 也可以创建不属于任何线程的轨道(例如 GPU)，但同一时间只能由一个线程写入
+class ProfileThreadBuffer {
+    friend class ProfileSystem;
+    friend class ProfileScope;
+
+public:
+    static constexpr uint32_t capacity = 1 << 14;
+    static constexpr uint32_t max_depth = 64;
+
+    // 当前线程的缓冲区，第一次调用时注册
+    static ProfileThreadBuffer* current();
+    // 创建一个独立的轨道，生命周期与进程相同
+    static ProfileThreadBuffer* create(const std::string& name);
+    static uint64_t now();
+    static uint64_t hashPath(uint64_t parent, const char* name, uint32_t depth) {
+        return (parent ^ reinterpret_cast<uint64_t>(name)) * 1099511628211ull + depth;
+    }
+
+    // 直接写入一个已经结束的作用域，返回其路径哈希
+    uint64_t recordScope(const char* name, uint32_t depth, uint64_t parent, uint64_t begin_ns, uint64_t end_ns) {
+        uint64_t path = hashPath(parent, name, depth);
+        push({name, path, parent, begin_ns, end_ns, depth, ProfileEventType::eScope, 0.0});
+        return path;
+    }
+    void recordCounter(const char* name, double value, uint64_t timestamp_ns = now()) {
+        push({name, 0, 0, timestamp_ns, timestamp_ns, 0, ProfileEventType::eCounter, value});
+    }
+
+private:
+    void push(const ProfileEvent& event) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[head % capacity] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+private:
+    uint32_t thread_id_ = 0;
+    std::string thread_name_;
+    // 仅本线程访问
+    uint32_t depth_ = 0;
+    uint64_t path_stack_[max_depth] = {};
+    // 环形缓冲区
+    std::vector<ProfileEvent> events_ = std::vector<ProfileEvent>(capacity);
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// RAII 作用域计时
+class ProfileScope {
+public:
+    ProfileScope(const char* name) {
+        buffer_ = ProfileThreadBuffer::current();
+        if (buffer_->depth_ >= ProfileThreadBuffer::max_depth) {
+            buffer_ = nullptr;
+            return;
+        }
+        event_.name = name;
+        event_.type = ProfileEventType::eScope;
+        event_.value = 0.0;
+        event_.depth = buffer_->depth_;
+        event_.parent = event_.depth == 0 ? 0 : buffer_->path_stack_[event_.depth - 1];
+        event_.path = ProfileThreadBuffer::hashPath(event_.parent, name, event_.depth);
+        buffer_->path_stack_[event_.depth] = event_.path;
+        buffer_->depth_++;
+        event_.begin_ns = ProfileThreadBuffer::now();
+    }
+
+    ~ProfileScope() {
+        if (buffer_ == nullptr) {
+            return;
+        }
+        event_.end_ns = ProfileThreadBuffer::now();
+        buffer_->depth_--;
+        buffer_->push(event_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileThreadBuffer* buffer_;
+    ProfileEvent event_;
+};
+
+// 单个作用域按帧统计的耗时
+struct ProfileStats {
+    std::string name;
+    uint64_t parent = 0;
+    uint32_t depth = 0;
+    uint32_t frame_count = 0;
+    uint64_t call_count = 0;
+    double total_ms = 0;
+    double min_ms = 0;
+    double max_ms = 0;
+
+    double averageMs() const { return frame_count == 0 ? 0 : total_ms / frame_count; }
+};
+
+// 计数器按帧累加后统计
+struct ProfileCounterStats {
+    std::string name;
+    uint32_t frame_count = 0;
+    double total = 0;
+    double min = 0;
+    double max = 0;
+
+    double average() const { return frame_count == 0 ? 0 : total / frame_count; }
+};
+
+class ProfileSystem final {
+    friend class Singleton<ProfileSystem>;
+    ProfileSystem();
+    ~ProfileSystem();
+
+public:
+    static void setThreadName(const std::string& name);
+    // 运行时生成的名字需要先驻留，返回的指针在进程结束前有效
+    static const char* internName(const std::string& name);
+    static void recordCounter(const char* name, double value);
+
+    // 收集所有线程的事件并累计到当前帧的统计中，每帧由逻辑线程调用一次
+    void endFrame();
+
+    // 开始记录事件，之后可以导出为 chrome://tracing / Perfetto 可读的 json
+    void beginCapture(uint32_t max_event_count = 1 << 20);
+    bool exportChromeTrace(const std::string& filename);
+
+    const std::map<uint64_t, ProfileStats>& getStats() const { return stats_; }
+    const std::map<std::string, ProfileCounterStats>& getCounterStats() const { return counter_stats_; }
+    uint32_t getFrameCount() const { return frame_count_; }
+    void report() const;
+    void reset();
+
+private:
+    void reportNode(uint64_t path, const std::multimap<uint64_t, uint64_t>& children) const;
+
+private:
+    struct FrameSample {
+        double ms = 0;
+        uint64_t calls = 0;
+    };
+
+    uint32_t frame_count_ = 0;
+    std::map<uint64_t, ProfileStats> stats_;
+    std::map<uint64_t, FrameSample> frame_samples_;
+    std::map<std::string, ProfileCounterStats> counter_stats_;
+    std::map<const char*, double> frame_counters_;
+
+    bool capturing_ = false;
+    uint32_t max_capture_event_count_ = 0;
+    std::vector<std::pair<uint32_t, ProfileEvent>> captured_events_;
+};
+
+}  // namespace wen
+
+#if defined(WEN_ENABLE_PROFILER)
+    #define WEN_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define WEN_PROFILE_CONCAT(a, b) WEN_PROFILE_CONCAT_IMPL(a, b)
+    #define WEN_PROFILE_SCOPE(name) \
+        wen::ProfileScope WEN_PROFILE_CONCAT(wen_profile_scope_, __LINE__)(name);
+    #define WEN_PROFILE_FUNCTION() WEN_PROFILE_SCOPE(__FUNCTION__)
+    #define WEN_PROFILE_THREAD(name) wen::ProfileSystem::setThreadName(name);
+    #define WEN_PROFILE_COUNTER(name, value) wen::ProfileSystem::recordCounter(name, value);
+#else
+    #define WEN_PROFILE_SCOPE(name)
+    #define WEN_PROFILE_FUNCTION()
+    #define WEN_PROFILE_THREAD(name)
+    #define WEN_PROFILE_COUNTER(name, value)
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/reflect/name_hash.hpp"
+#include "core/reflect/traits/member.hpp"
+#include "core/reflect/traits/function.hpp"
+#include <span>
+
+namespace wen {
+
+// 解析一次后缓存，指向只读的常量表，只能用于解析它的类的对象
+struct MemberHandle {
+    const Member* member = nullptr;
+
+    bool isValid() const { return member != nullptr; }
+
+    // 类型不符或句柄无效时返回无效的成员
+    template <typename T>
+    TypedMember<T> getTyped() const {
+        return member != nullptr ? member->getTyped<T>() : TypedMember<T>{};
+    }
+};
+
+struct FunctionHandle {
+    const Function* function = nullptr;
+
+    bool isValid() const { return function != nullptr; }
+
+    // 签名不符或句柄无效时返回无效的函数
+    template <typename Signature>
+    TypedFunction<Signature> getTyped() const {
+        return function != nullptr ? function->getTyped<Signature>() : TypedFunction<Signature>{};
+    }
+};
+
+// 名字哈希到数组下标的索引项，按哈希排序
+struct NameIndex {
+    NameID id;
+    uint32_t index;
+};
+
+// 类的反射信息，由 parser.py 生成为编译期常量，成员和函数按声明顺序存放
+class ClassDescriptor {
+public:
+    constexpr ClassDescriptor(std::string_view class_name,
+                              NameID class_id,
+                              std::span<const Member> members,
+                              std::span<const NameIndex> member_index,
+                              std::span<const Function> functions,
+                              std::span<const NameIndex> function_index)
+        : class_name_(class_name),
+          class_id_(class_id),
+          members_(members),
+          member_index_(member_index),
+          functions_(functions),
+          function_index_(function_index) {}
+
+    std::string_view getClassName() const { return class_name_; }
+    NameID getClassID() const { return class_id_; }
+
+    MemberHandle findMember(NameID id) const {
+        auto index = find(member_index_, id);
+        return {index < members_.size() ? &members_[index] : nullptr};
+    }
+    // 按名字查找时再比较名字，哈希冲突的名字不会找到别的成员
+    MemberHandle findMember(std::string_view name) const {
+        auto handle = findMember(hashName(name));
+        return handle.isValid() && handle.member->getName() == name ? handle : MemberHandle{};
+    }
+
+    FunctionHandle findFunction(NameID id) const {
+        auto index = find(function_index_, id);
+        return {index < functions_.size() ? &functions_[index] : nullptr};
+    }
+    FunctionHandle findFunction(std::string_view name) const {
+        auto handle = findFunction(hashName(name));
+        return handle.isValid() && handle.function->getName() == name ? handle : FunctionHandle{};
+    }
+
+    const Member& getMember(NameID id) const {
+        auto handle = findMember(id);
+        if (!handle.isValid()) {
+            WEN_CORE_ERROR("Member {:#x} not in class {}", id, class_name_)
+            throw std::out_of_range("member not found");
+        }
+        return *handle.member;
+    }
+
+    const Member& getMember(std::string_view name) const {
+        auto handle = findMember(name);
+        if (!handle.isValid()) {
+            WEN_CORE_ERROR("Member {} not in class {}", name, class_name_)
+            throw std::out_of_range("member not found");
+        }
+        return *handle.member;
+    }
+
+    const Function& getFunction(NameID id) const {
+        auto handle = findFunction(id);
+        if (!handle.isValid()) {
+            WEN_CORE_ERROR("Function {:#x} not in class {}", id, class_name_)
+            throw std::out_of_range("function not found");
+        }
+        return *handle.function;
+    }
+
+    const Function& getFunction(std::string_view name) const {
+        auto handle = findFunction(name);
+        if (!handle.isValid()) {
+            WEN_CORE_ERROR("Function {} not in class {}", name, class_name_)
+            throw std::out_of_range("function not found");
+        }
+        return *handle.function;
+    }
+
+    // 按声明顺序
+    std::span<const Member> getMembers() const { return members_; }
+    std::span<const Function> getFunctions() const { return functions_; }
+
+    // 没有找到时返回 uint32_t 最大值
+    static uint32_t find(std::span<const NameIndex> index, NameID id) {
+        auto iter = std::lower_bound(index.begin(), index.end(), id, [](const NameIndex& entry, NameID id) { return entry.id < id; });
+        return iter != index.end() && iter->id == id ? iter->index : std::numeric_limits<uint32_t>::max();
+    }
+
+private:
+    std::string_view class_name_;
+    NameID class_id_;
+    std::span<const Member> members_;
+    std::span<const NameIndex> member_index_;
+    std::span<const Function> functions_;
+    std::span<const NameIndex> function_index_;
+};
+
+}  // namespace wen
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace wen {
+
+// 反射名字的 64 位 FNV-1a 哈希，parser.py 生成的注册代码直接使用相同算法算出的常量
+using NameID = uint64_t;
+
+constexpr NameID hashName(std::string_view name) {
+    NameID hash = 0xcbf29ce484222325ull;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// 保证在编译期求值，用于调用处的常量 ID
+consteval NameID operator""_id(const char* name, size_t length) { return hashName({name, length}); }
+
+}  // namespace wen
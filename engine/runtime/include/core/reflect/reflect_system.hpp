@@ -1,7 +1,7 @@
 #pragma once
 
 #include "core/base/singleton.hpp"
-#include "core/reflect/class_builder.hpp"
+#include "core/reflect/class_descriptor.hpp"
 
 namespace wen {
 
@@ -11,24 +11,23 @@ class ReflectSystem final {
     ~ReflectSystem();
 
 public:
-    template <class C>
-    ClassBuilder<C> addClass(const std::string& class_name) {
-        auto class_builder = ClassBuilder<C>(class_name);
-        auto descriptor = class_builder.descriptor_;
-        if (classes_.find(descriptor->class_name_) == classes_.end()) {
-            classes_.insert({descriptor->class_name_, descriptor});
-        } else {
-            WEN_CORE_ERROR("Class {} has been added.", descriptor->class_name_)
-        }
-        return class_builder;
-    }
+    // 发布 parser.py 生成的只读常量表，class_index 按类名哈希排序，不复制
+    void publish(std::span<const ClassDescriptor* const> classes, std::span<const NameIndex> class_index);
 
+    // 没有找到时返回 nullptr
+    const ClassDescriptor* findClass(NameID id) const {
+        auto index = ClassDescriptor::find(class_index_, id);
+        return index < classes_.size() ? classes_[index] : nullptr;
+    }
+    const ClassDescriptor* findClass(std::string_view name) const { return findClass(hashName(name)); }
     const ClassDescriptor& getClass(const std::string& name) const;
+    std::span<const ClassDescriptor* const> getClasses() const { return classes_; }
 
     void registerReflectProperties();
 
 private:
-    std::map<std::string, ClassDescriptor*> classes_;
+    std::span<const ClassDescriptor* const> classes_;
+    std::span<const NameIndex> class_index_;
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
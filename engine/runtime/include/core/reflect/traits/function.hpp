@@ -1,138 +1,283 @@
 #pragma once
 
 #include "core/reflect/traits/any.hpp"
+#include "core/reflect/traits/member.hpp"
 
 namespace wen {
 
-class Function {
-public:
-    template <class C, typename... Args>
-    Function(void (C::*func)(Args...)) {
-        callback_ = [func_ptr = func](void* obj, std::any args) {
-            auto wrapper =
-                std::any_cast<std::array<Any, sizeof...(Args) + 1>*>(args);
-            (*wrapper)[0] = Any(*static_cast<C*>(obj));
-            std::tuple<C&, Args...> call_args = AnyToTuple<C&, Args...>(
-                *wrapper, std::make_index_sequence<sizeof...(Args) + 1>{});
-            std::apply(func_ptr, call_args);
-            return std::any();
-        };
-        create_result_ = [](std::any) { return Any(); };
+template <typename F>
+struct MemberFunctionTraits;
+
+template <typename R, class C, typename... Args>
+struct MemberFunctionTraits<R (C::*)(Args...)> {
+    using Return = R;
+    using Class = C;
+    using Arguments = std::tuple<Args...>;
+    static constexpr bool is_const = false;
+};
+
+template <typename R, class C, typename... Args>
+struct MemberFunctionTraits<R (C::*)(Args...) const> : MemberFunctionTraits<R (C::*)(Args...)> {
+    static constexpr bool is_const = true;
+};
+
+template <typename R, class C, typename... Args>
+struct MemberFunctionTraits<R (C::*)(Args...) noexcept> : MemberFunctionTraits<R (C::*)(Args...)> {};
+
+template <typename R, class C, typename... Args>
+struct MemberFunctionTraits<R (C::*)(Args...) const noexcept> : MemberFunctionTraits<R (C::*)(Args...) const> {};
+
+// 返回引用的函数在返回值存储中写入指针
+template <typename R>
+using ReturnStorage = std::conditional_t<std::is_reference_v<R>, std::remove_reference_t<R>*, R>;
+
+// 直接调用成员函数的跳板，args[i] 指向第 i 个参数（去掉引用和 const 的类型）的对象
+// ret 指向未初始化的返回值存储，在其中构造返回值，由调用方析构
+using FunctionThunk = void (*)(void* obj, void** args, void* ret);
+
+// 参数的绑定方式，类型标签去掉了引用和 const，调用时另外按 C++ 的规则检查
+// 非 const 的左值引用参数只接受非 const 的左值，非 const 的右值引用参数只接受非 const 的右值
+enum class ArgumentBinding : uint8_t {
+    eAny,
+    eLvalue,
+    eRvalue
+};
+
+template <typename Arg>
+constexpr ArgumentBinding getArgumentBinding() {
+    if constexpr (std::is_const_v<std::remove_reference_t<Arg>>) {
+        return ArgumentBinding::eAny;
+    } else if constexpr (std::is_lvalue_reference_v<Arg>) {
+        return ArgumentBinding::eLvalue;
+    } else if constexpr (std::is_rvalue_reference_v<Arg>) {
+        return ArgumentBinding::eRvalue;
+    } else {
+        return ArgumentBinding::eAny;
     }
+}
 
-    template <class C, typename... Args>
-    Function(void (C::*func)(Args...) const) {
-        callback_ = [func_ptr = func](void* obj, std::any args) {
-            auto wrapper =
-                std::any_cast<std::array<Any, sizeof...(Args) + 1>*>(args);
-            (*wrapper)[0] = Any(*static_cast<const C*>(obj));
-            std::tuple<const C&, Args...> call_args =
-                AnyToTuple<const C&, Args...>(
-                    *wrapper, std::make_index_sequence<sizeof...(Args) + 1>{});
-            std::apply(func_ptr, call_args);
-            return std::any();
-        };
-        create_result_ = [](std::any) { return Any(); };
+// CallArg 是转发引用推导出的类型，不是引用时为右值
+template <typename CallArg>
+constexpr bool canBindArgument(ArgumentBinding binding) {
+    constexpr bool is_mutable = !std::is_const_v<std::remove_reference_t<CallArg>>;
+    switch (binding) {
+        case ArgumentBinding::eLvalue:
+            return is_mutable && std::is_lvalue_reference_v<CallArg>;
+        case ArgumentBinding::eRvalue:
+            return is_mutable && !std::is_lvalue_reference_v<CallArg>;
+        default:
+            return true;
     }
+}
 
-    template <typename R, class C, typename... Args>
-    Function(R (C::*func)(Args...)) {
-        callback_ = [func_ptr = func](void* obj, std::any args) {
-            auto wrapper =
-                std::any_cast<std::array<Any, sizeof...(Args) + 1>*>(args);
-            (*wrapper)[0] = Any(*static_cast<C*>(obj));
-            std::tuple<C&, Args...> call_args = AnyToTuple<C&, Args...>(
-                *wrapper, std::make_index_sequence<sizeof...(Args) + 1>{});
-            return std::any(std::apply(func_ptr, call_args));
-        };
-        create_result_ = [](std::any result) {
-            return Any(std::any_cast<R>(result));
-        };
+// 按值传递的参数从调用方的对象复制，只有右值引用参数才会移动
+// 调用之前已经用 canBindArgument 检查过，去掉 const 不会修改调用方的 const 对象
+template <typename Arg>
+decltype(auto) forwardArgument(void* arg) {
+    auto& value = *static_cast<std::remove_cvref_t<Arg>*>(arg);
+    if constexpr (std::is_rvalue_reference_v<Arg>) {
+        return std::move(value);
+    } else {
+        return (value);
     }
+}
 
-    template <typename R, class C, typename... Args>
-    Function(R (C::*func)(Args...) const) {
-        callback_ = [func_ptr = func](void* obj, std::any args) {
-            auto wrapper =
-                std::any_cast<std::array<Any, sizeof...(Args) + 1>*>(args);
-            (*wrapper)[0] = Any(*static_cast<const C*>(obj));
-            std::tuple<const C&, Args...> call_args =
-                AnyToTuple<const C&, Args...>(
-                    *wrapper, std::make_index_sequence<sizeof...(Args) + 1>{});
-            return std::any(std::apply(func_ptr, call_args));
-        };
-        create_result_ = [](std::any result) {
-            return Any(std::any_cast<R>(result));
-        };
+template <auto func, typename R, class C, typename... Args, size_t... Indices>
+void callFunctionThunk(void* obj, void** args, void* ret, std::index_sequence<Indices...>) {
+    auto* object = static_cast<C*>(obj);
+    if constexpr (std::is_void_v<R>) {
+        (object->*func)(forwardArgument<Args>(args[Indices])...);
+    } else if constexpr (std::is_reference_v<R>) {
+        // 右值引用的返回值也按指针保存，取出时再转换回 R
+        auto&& result = (object->*func)(forwardArgument<Args>(args[Indices])...);
+        new (ret) ReturnStorage<R>(std::addressof(result));
+    } else {
+        new (ret) R((object->*func)(forwardArgument<Args>(args[Indices])...));
     }
+}
+
+template <auto func>
+void functionThunk(void* obj, void** args, void* ret) {
+    using Traits = MemberFunctionTraits<decltype(func)>;
+    [&]<typename... Args>(std::tuple<Args...>*) {
+        callFunctionThunk<func, typename Traits::Return, typename Traits::Class, Args...>(obj, args, ret, std::index_sequence_for<Args...>{});
+    }(static_cast<typename Traits::Arguments*>(nullptr));
+}
+
+template <typename... Args>
+inline constexpr const void* argument_type_tags[sizeof...(Args) + 1] = {getTypeTag<Args>()..., nullptr};
+
+template <typename... Args>
+inline constexpr ArgumentBinding argument_bindings[sizeof...(Args) + 1] = {getArgumentBinding<Args>()..., ArgumentBinding::eAny};
+
+template <typename Signature>
+struct TypedFunction;
+
+// 签名检查过一次的函数，调用只剩一次间接调用，参数和返回值都在栈上
+template <typename R, typename... Args>
+struct TypedFunction<R(Args...)> {
+    FunctionThunk thunk = nullptr;
 
-    Function(const Function& rhs) {
-        callback_ = rhs.callback_;
-        create_result_ = rhs.create_result_;
+    bool isValid() const { return thunk != nullptr; }
+
+    template <typename... CallArgs>
+    R invoke(void* obj, CallArgs&&... args) const {
+        static_assert((std::is_same_v<std::remove_cvref_t<Args>, std::remove_cvref_t<CallArgs>> && ...), "argument types mismatch");
+        static_assert((canBindArgument<CallArgs>(getArgumentBinding<Args>()) && ...), "argument cannot bind to reference parameter");
+        std::array<void*, sizeof...(Args)> arguments = {const_cast<void*>(static_cast<const void*>(&args))...};
+        if constexpr (std::is_void_v<R>) {
+            thunk(obj, arguments.data(), nullptr);
+        } else {
+            alignas(ReturnStorage<R>) std::byte storage[sizeof(ReturnStorage<R>)];
+            thunk(obj, arguments.data(), storage);
+            auto* result = std::launder(reinterpret_cast<ReturnStorage<R>*>(storage));
+            if constexpr (std::is_reference_v<R>) {
+                return static_cast<R>(**result);
+            } else {
+                R value = std::move(*result);
+                result->~R();
+                return value;
+            }
+        }
+    }
+};
+
+template <typename R>
+Any createFunctionResult(FunctionThunk thunk, void* obj, void** args) {
+    if constexpr (std::is_void_v<R>) {
+        thunk(obj, args, nullptr);
+        return Any();
+    } else if constexpr (std::is_reference_v<R>) {
+        ReturnStorage<R> result;
+        thunk(obj, args, &result);
+        return Any(*result);
+    } else {
+        alignas(R) std::byte storage[sizeof(R)];
+        thunk(obj, args, storage);
+        auto* result = std::launder(reinterpret_cast<R*>(storage));
+        Any value(std::move(*result));
+        result->~R();
+        return value;
     }
+}
 
-    Function(Function&& rhs) {
-        callback_ = std::move(rhs.callback_);
-        create_result_ = std::move(rhs.create_result_);
+// 由 parser.py 生成的常量表在编译期构造
+class Function {
+public:
+    template <auto func>
+    static constexpr Function create(std::string_view name, NameID id) {
+        using Traits = MemberFunctionTraits<decltype(func)>;
+        using R = typename Traits::Return;
+        Function function;
+        function.name_ = name;
+        function.id_ = id;
+        function.thunk_ = &functionThunk<func>;
+        function.is_const_ = Traits::is_const;
+        function.return_tag_ = getTypeTag<R>();
+        [&]<typename... Args>(std::tuple<Args...>*) {
+            function.argument_count_ = sizeof...(Args);
+            function.argument_tags_ = argument_type_tags<Args...>;
+            function.argument_bindings_ = argument_bindings<Args...>;
+        }(static_cast<typename Traits::Arguments*>(nullptr));
+        function.create_result_ = &createFunctionResult<R>;
+        return function;
+    }
+
+    // 参数和返回值的约定见 FunctionThunk
+    void call(void* obj, void** args, void* ret) const { thunk_(obj, args, ret); }
+
+    // 签名不符时返回无效的函数
+    template <typename Signature>
+    TypedFunction<Signature> getTyped() const {
+        return checkSignature(static_cast<Signature*>(nullptr)) ? TypedFunction<Signature>{thunk_} : TypedFunction<Signature>{};
     }
 
     template <class C, typename... Args>
     Any invoke(C& obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return create_result_(callback_(&obj, &wrapper));
+        return invokeByPtr(static_cast<void*>(&obj), std::forward<Args>(args)...);
     }
 
     template <typename... Args>
     Any invokeByPtr(void* obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return create_result_(callback_(obj, &wrapper));
+        checkArguments<Args...>();
+        std::array<void*, sizeof...(Args)> arguments = {const_cast<void*>(static_cast<const void*>(&args))...};
+        return create_result_(thunk_, obj, arguments.data());
     }
 
     template <typename... Args>
     Any invokeByPtr(const void* obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return create_result_(callback_(obj, &wrapper));
+        return invokeByPtr(const_cast<void*>(obj), std::forward<Args>(args)...);
     }
 
     template <typename R, class C, typename... Args>
     R invokeEx(C& obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return std::any_cast<R>(callback_(&obj, &wrapper));
+        return invokeByPtrEx<R>(static_cast<void*>(&obj), std::forward<Args>(args)...);
     }
 
     template <typename R, typename... Args>
     R invokeByPtrEx(void* obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return std::any_cast<R>(callback_(obj, &wrapper));
+        checkArguments<Args...>();
+        if (return_tag_ != getTypeTag<R>()) {
+            WEN_CORE_ERROR("Function return type mismatch with {}", typeid(R).name())
+            throw std::bad_any_cast();
+        }
+        return TypedFunction<R(Args...)>{thunk_}.invoke(obj, std::forward<Args>(args)...);
     }
 
     template <typename R, typename... Args>
     R invokeByPtrEx(const void* obj, Args&&... args) const {
-        std::array<Any, sizeof...(Args) + 1> wrapper = {
-            Any(),
-            Any(std::forward<Args>(args))...,
-        };
-        return std::any_cast<R>(callback_(obj, &wrapper));
+        return invokeByPtrEx<R>(const_cast<void*>(obj), std::forward<Args>(args)...);
+    }
+
+    std::string_view getName() const { return name_; }
+    NameID getID() const { return id_; }
+    uint32_t getArgumentCount() const { return argument_count_; }
+    bool isConst() const { return is_const_; }
+
+private:
+    constexpr Function() = default;
+
+    template <typename... Args>
+    bool matchArguments() const {
+        if (argument_count_ != sizeof...(Args)) {
+            return false;
+        }
+        const void* tags[] = {getTypeTag<Args>()..., nullptr};
+        if (!std::equal(tags, tags + sizeof...(Args), argument_tags_)) {
+            return false;
+        }
+        return [&]<size_t... Indices>(std::index_sequence<Indices...>) {
+            return (canBindArgument<Args>(argument_bindings_[Indices]) && ...);
+        }(std::index_sequence_for<Args...>{});
+    }
+
+    template <typename R, typename... Args>
+    bool checkSignature(R (*)(Args...)) const {
+        if (return_tag_ != getTypeTag<R>() || !matchArguments<Args...>()) {
+            WEN_CORE_ERROR("Function signature mismatch with {}", typeid(R(Args...)).name())
+            return false;
+        }
+        return true;
+    }
+
+    template <typename... Args>
+    void checkArguments() const {
+        if (!matchArguments<Args...>()) {
+            WEN_CORE_ERROR("Function arguments mismatch with {}", typeid(void(Args...)).name())
+            throw std::bad_any_cast();
+        }
     }
 
 private:
-    std::function<std::any(void*, std::any)> callback_;
-    std::function<Any(std::any)> create_result_;
+    std::string_view name_;
+    NameID id_ = 0;
+    FunctionThunk thunk_ = nullptr;
+    uint32_t argument_count_ = 0;
+    const void* const* argument_tags_ = nullptr;
+    const ArgumentBinding* argument_bindings_ = nullptr;
+    const void* return_tag_ = nullptr;
+    bool is_const_ = false;
+    Any (*create_result_)(FunctionThunk thunk, void* obj, void** args) = nullptr;
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "core/reflect/traits/any.hpp"
+#include "core/reflect/name_hash.hpp"
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace wen {
 
+// 新的类型追加在末尾，已有的值不变
 enum class MemberType {
     eInt,
     eFloat,
@@ -13,171 +16,224 @@ enum class MemberType {
     eVec3,
     eVec4,
     eString,
-    eCustom
+    eCustom,
+    eUint,
+    eDouble,
+    eQuat,
+    eMat4
 };
 
-class Member {
-public:
-    template <class C, typename T>
-    Member(T C::* member) {
-        if constexpr (std::is_same_v<T, int>) {
-            type_ = MemberType::eInt;
-        } else if constexpr (std::is_same_v<T, float>) {
-            type_ = MemberType::eFloat;
-        } else if constexpr (std::is_same_v<T, bool>) {
-            type_ = MemberType::eBool;
-        } else if constexpr (std::is_same_v<T, glm::vec2>) {
-            type_ = MemberType::eVec2;
-        } else if constexpr (std::is_same_v<T, glm::vec3>) {
-            type_ = MemberType::eVec3;
-        } else if constexpr (std::is_same_v<T, glm::vec4>) {
-            type_ = MemberType::eVec4;
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            type_ = MemberType::eString;
-        } else {
-            type_ = MemberType::eCustom;
-        }
-
-        getter_const_ = [ptr = member](const void* obj) {
-            return &(static_cast<const C*>(obj)->*ptr);
-        };
-
-        getter_reference_ = [ptr = member](void* obj) {
-            return &(static_cast<C*>(obj)->*ptr);
-        };
+// 每种类型一个唯一的地址，用于不依赖 RTTI 的类型检查
+// 不能是常量，内容相同的只读常量会被链接器的相同数据折叠（MSVC /OPT:ICF、lld --icf=all）合并到同一个地址
+template <typename T>
+struct TypeTag {
+    inline static char id;
+};
 
-        setter_copy_ = [ptr = member](void* obj, std::any value) {
-            static_cast<C*>(obj)->*ptr = *std::any_cast<T*>(value);
-        };
+template <typename T>
+constexpr const void* getTypeTag() {
+    return &TypeTag<std::remove_cvref_t<T>>::id;
+}
+
+template <typename T>
+constexpr MemberType getMemberType() {
+    if constexpr (std::is_same_v<T, int>) {
+        return MemberType::eInt;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return MemberType::eUint;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return MemberType::eFloat;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return MemberType::eDouble;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return MemberType::eBool;
+    } else if constexpr (std::is_same_v<T, glm::vec2>) {
+        return MemberType::eVec2;
+    } else if constexpr (std::is_same_v<T, glm::vec3>) {
+        return MemberType::eVec3;
+    } else if constexpr (std::is_same_v<T, glm::vec4>) {
+        return MemberType::eVec4;
+    } else if constexpr (std::is_same_v<T, glm::quat>) {
+        return MemberType::eQuat;
+    } else if constexpr (std::is_same_v<T, glm::mat4>) {
+        return MemberType::eMat4;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return MemberType::eString;
+    } else {
+        return MemberType::eCustom;
+    }
+}
 
-        setter_copy_const_ = [ptr = member](void* obj, std::any value) {
-            static_cast<C*>(obj)->*ptr = *std::any_cast<const T*>(value);
-        };
+// 类型检查过一次的成员，访问只剩指针运算
+template <typename T>
+struct TypedMember {
+    static constexpr uint32_t invalid_offset = std::numeric_limits<uint32_t>::max();
 
-        setter_move_ = [ptr = member](void* obj, std::any value) {
-            static_cast<C*>(obj)->*ptr = std::move(*std::any_cast<T*>(value));
-        };
+    uint32_t offset = invalid_offset;
 
-        setter_value_ = [ptr = member](void* obj, std::any value) {
-            static_cast<C*>(obj)->*ptr = std::any_cast<T>(value);
-        };
+    bool isValid() const { return offset != invalid_offset; }
+    T& get(void* obj) const { return *reinterpret_cast<T*>(static_cast<std::byte*>(obj) + offset); }
+    const T& get(const void* obj) const { return *reinterpret_cast<const T*>(static_cast<const std::byte*>(obj) + offset); }
+};
 
-        create_result_const_ = [](std::any value) {
-            return Any(*std::any_cast<const T*>(value));
-        };
+template <typename T>
+void copyMemberValue(void* dst, const void* src) {
+    *static_cast<T*>(dst) = *static_cast<const T*>(src);
+}
 
-        create_result_reference_ = [](std::any value) {
-            return Any(*std::any_cast<T*>(value));
-        };
-    }
+template <typename T>
+Any createMemberResultConst(const void* value) {
+    return Any(*static_cast<const T*>(value));
+}
 
-    Member(const Member& rhs) {
-        type_ = rhs.type_;
-        getter_const_ = rhs.getter_const_;
-        getter_reference_ = rhs.getter_reference_;
-        setter_copy_ = rhs.setter_copy_;
-        setter_copy_const_ = rhs.setter_copy_const_;
-        setter_move_ = rhs.setter_move_;
-        setter_value_ = rhs.setter_value_;
-        create_result_const_ = rhs.create_result_const_;
-        create_result_reference_ = rhs.create_result_reference_;
-    }
+template <typename T>
+Any createMemberResultReference(void* value) {
+    return Any(*static_cast<T*>(value));
+}
 
-    Member(Member&& rhs) {
-        type_ = rhs.type_;
-        getter_const_ = std::move(rhs.getter_const_);
-        getter_reference_ = std::move(rhs.getter_reference_);
-        setter_copy_ = std::move(rhs.setter_copy_);
-        setter_copy_const_ = std::move(rhs.setter_copy_const_);
-        setter_move_ = std::move(rhs.setter_move_);
-        setter_value_ = std::move(rhs.setter_value_);
-        create_result_const_ = std::move(rhs.create_result_const_);
-        create_result_reference_ = std::move(rhs.create_result_reference_);
+// 成员用相对对象起始地址的偏移描述，读写没有堆分配
+// 由 parser.py 生成的常量表在编译期构造，对象指针必须指向类的起始地址，反射的类不能使用虚继承
+class Member {
+public:
+    // offset 为 offsetof(C, member)
+    template <typename T>
+    static constexpr Member create(std::string_view name, NameID id, uint32_t offset) {
+        Member member;
+        member.name_ = name;
+        member.id_ = id;
+        member.type_ = getMemberType<T>();
+        member.type_tag_ = getTypeTag<T>();
+        member.offset_ = offset;
+        member.size_ = sizeof(T);
+        member.trivially_copyable_ = std::is_trivially_copyable_v<T>;
+        if constexpr (std::is_copy_assignable_v<T>) {
+            member.copy_ = &copyMemberValue<T>;
+        }
+        member.create_result_const_ = &createMemberResultConst<T>;
+        member.create_result_reference_ = &createMemberResultReference<T>;
+        return member;
     }
 
     template <class C>
     Any getValueConst(const C& obj) const {
-        return create_result_const_(
-            getter_const_(static_cast<const void*>(&obj)));
+        return getValueConstByPtr(static_cast<const void*>(&obj));
     }
 
     template <typename T, class C>
     const T& getValueConst(const C& obj) const {
-        return *std::any_cast<const T*>(
-            getter_const_(static_cast<const void*>(&obj)));
+        return getValueConstByPtr<T>(static_cast<const void*>(&obj));
     }
 
-    Any getValueConstByPtr(const void* obj) const {
-        return create_result_const_(getter_const_(obj));
-    }
+    Any getValueConstByPtr(const void* obj) const { return create_result_const_(getAddress(obj)); }
 
     template <typename T>
     const T& getValueConstByPtr(const void* obj) const {
-        return *std::any_cast<const T*>(getter_const_(obj));
+        checkType<T>();
+        return *static_cast<const T*>(getAddress(obj));
     }
 
     template <class C>
     Any getValueReference(C& obj) const {
-        return create_result_reference_(
-            getter_reference_(static_cast<void*>(&obj)));
+        return getValueReferenceByPtr(static_cast<void*>(&obj));
     }
 
     template <typename T, class C>
     T& getValueReference(C& obj) const {
-        return *std::any_cast<T*>(getter_reference_(static_cast<void*>(&obj)));
+        return getValueReferenceByPtr<T>(static_cast<void*>(&obj));
     }
 
-    Any getValueReferenceByPtr(void* obj) const {
-        return create_result_reference_(getter_reference_(obj));
-    }
+    Any getValueReferenceByPtr(void* obj) const { return create_result_reference_(getAddress(obj)); }
 
     template <typename T>
     T& getValueReferenceByPtr(void* obj) const {
-        return *std::any_cast<T*>(getter_reference_(obj));
+        checkType<T>();
+        return *static_cast<T*>(getAddress(obj));
     }
 
     template <class C, typename T>
     void setValue(C& obj, T&& value) const {
-        if constexpr (std::is_lvalue_reference_v<T>) {
-            if constexpr (std::is_const_v<std::remove_reference_t<T>>) {
-                setter_copy_const_(static_cast<void*>(&obj), &value);
-            } else {
-                setter_copy_(static_cast<void*>(&obj), &value);
-            }
-        } else if constexpr (std::is_rvalue_reference_v<T>) {
-            setter_move_(static_cast<void*>(&obj), &value);
-        } else {
-            setter_value_(static_cast<void*>(&obj), value);
-        }
+        setValueByPtr(static_cast<void*>(&obj), std::forward<T>(value));
     }
 
     template <typename T>
     void setValueByPtr(void* obj, T&& value) const {
-        if constexpr (std::is_lvalue_reference_v<T>) {
-            if constexpr (std::is_const_v<std::remove_reference_t<T>>) {
-                setter_copy_const_(obj, &value);
-            } else {
-                setter_copy_(obj, &value);
-            }
-        } else if constexpr (std::is_rvalue_reference_v<T>) {
-            setter_move_(obj, &value);
+        using RawT = std::remove_cvref_t<T>;
+        checkType<RawT>();
+        *static_cast<RawT*>(getAddress(obj)) = std::forward<T>(value);
+    }
+
+    // 类型不符时返回无效的成员
+    template <typename T>
+    TypedMember<T> getTyped() const {
+        if (type_tag_ != getTypeTag<T>()) {
+            WEN_CORE_ERROR("Member type mismatch with {}", typeid(T).name())
+            return {};
+        }
+        return {offset_};
+    }
+
+    // 按字节读写，value 指向一个同类型的对象，可以平凡复制的成员直接复制内存
+    void copyValueTo(const void* obj, void* value) const {
+        if (trivially_copyable_) {
+            std::memcpy(value, getAddress(obj), size_);
         } else {
-            setter_value_(obj, value);
+            copy_(value, getAddress(obj));
+        }
+    }
+
+    void copyValueFrom(void* obj, const void* value) const {
+        if (trivially_copyable_) {
+            std::memcpy(getAddress(obj), value, size_);
+        } else {
+            copy_(getAddress(obj), value);
+        }
+    }
+
+    // 把同一个值写入多个对象，用于编辑器批量修改属性
+    // 不会调用 RTTI::onPropertyChanged，写入组件时用 RTTI::copyValueFrom 或者之后自己调用
+    void copyValueFrom(void* const* objs, size_t count, const void* value) const {
+        for (size_t i = 0; i < count; i++) {
+            copyValueFrom(objs[i], value);
         }
     }
 
+    std::string_view getName() const { return name_; }
+    NameID getID() const { return id_; }
     MemberType getType() const { return type_; }
+    uint32_t getOffset() const { return offset_; }
+    uint32_t getSize() const { return size_; }
+    bool isTriviallyCopyable() const { return trivially_copyable_; }
+
+    template <typename T>
+    bool isType() const {
+        return type_tag_ == getTypeTag<T>();
+    }
+
+private:
+    constexpr Member() = default;
+
+    const void* getAddress(const void* obj) const { return static_cast<const std::byte*>(obj) + offset_; }
+    void* getAddress(void* obj) const { return static_cast<std::byte*>(obj) + offset_; }
+
+    template <typename T>
+    void checkType() const {
+        if (type_tag_ != getTypeTag<T>()) {
+            WEN_CORE_ERROR("Member type mismatch with {}", typeid(T).name())
+            throw std::bad_any_cast();
+        }
+    }
 
 private:
-    MemberType type_;
-    std::function<std::any(const void*)> getter_const_;
-    std::function<std::any(void*)> getter_reference_;
-    std::function<void(void*, std::any)> setter_copy_;
-    std::function<void(void*, std::any)> setter_copy_const_;
-    std::function<void(void*, std::any)> setter_move_;
-    std::function<void(void*, std::any)> setter_value_;
-    std::function<Any(std::any)> create_result_const_;
-    std::function<Any(std::any)> create_result_reference_;
+    std::string_view name_;
+    NameID id_ = 0;
+    MemberType type_ = MemberType::eCustom;
+    const void* type_tag_ = nullptr;
+    uint32_t offset_ = 0;
+    uint32_t size_ = 0;
+    bool trivially_copyable_ = false;
+    void (*copy_)(void* dst, const void* src) = nullptr;
+    Any (*create_result_const_)(const void* value) = nullptr;
+    Any (*create_result_reference_)(void* value) = nullptr;
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/serialize/stream_io.hpp"
+
+namespace wen {
+
+class JobSystem;
+
+// LZ4 块格式的压缩，每个块独立压缩，不依赖之前的块
+// 序列：token（高 4 位字面量长度，低 4 位匹配长度减 4，为 15 时后面跟 255 累加的扩展字节），字面量，2 字节小端偏移，最后一个序列只有字面量
+size_t getCompressBound(size_t size);
+// 压缩后没有变小或者放不下时返回 0，调用方按原样存储
+size_t compressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+// 数据损坏或者解压后的大小与 raw_size 不符时返回 false
+bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t raw_size);
+
+// 压缩帧：uint32 magic，uint32 块大小，uint64 解压后的总大小，之后每块 uint32 原始大小、uint32 存储大小（最高位表示原样存储）、数据，原始大小为 0 的块表示结束
+struct CompressedFrame {
+    static constexpr uint32_t magic = 0x5a4c4e57;  // "WNLZ"
+    static constexpr uint32_t raw_flag = 0x80000000;
+    static constexpr size_t default_block_size = 256 << 10;
+    static constexpr size_t max_block_size = 64 << 20;
+    // 每个压缩字节最多解压出的字节数，用于检查文件头中的总大小
+    static constexpr uint64_t max_ratio = 256;
+
+    static bool isCompressed(std::span<const uint8_t> data);
+};
+
+// 压缩后交给下一级 sink，放在 SerializeStream 和 FileSink 之间
+// 解压后的总大小写在帧头中，读取时用来检查数据长度，写入的字节数必须与 raw_size 相同
+// 一次攒满一批块后在 job_system 的工作线程上并行压缩，按顺序写出，占用的内存不超过一批块的大小
+class CompressSink final : public StreamSink {
+public:
+    CompressSink(StreamSink& sink, uint64_t raw_size, size_t block_size = CompressedFrame::default_block_size, JobSystem* job_system = nullptr);
+    // 没有调用 finish 时写入结束标记
+    ~CompressSink() override;
+
+    CompressSink(const CompressSink&) = delete;
+    CompressSink& operator=(const CompressSink&) = delete;
+
+    bool write(const void* data, size_t size) override;
+    // 压缩已经写入的数据，不足一块的数据单独成块
+    bool flush() override;
+    // 写入结束标记，之后不能再写入，写入的字节数与 raw_size 不符时返回 false
+    bool finish();
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> raw;
+        std::unique_ptr<uint8_t[]> packed;
+        size_t raw_size = 0;
+        size_t packed_size = 0;
+    };
+
+    bool writeBlocks();
+
+private:
+    StreamSink& sink_;
+    uint64_t raw_size_;
+    uint64_t written_size_ = 0;
+    size_t block_size_;
+    JobSystem* job_system_;
+    std::vector<Block> blocks_;
+    // 正在写入的块
+    uint32_t block_index_ = 0;
+    bool finished_ = false;
+    bool good_ = true;
+};
+
+// 从上一级 source 读取压缩帧并解压，一次读入一批块后在 job_system 的工作线程上并行解压
+class DecompressSource final : public StreamSource {
+public:
+    explicit DecompressSource(StreamSource& source, JobSystem* job_system = nullptr);
+
+    DecompressSource(const DecompressSource&) = delete;
+    DecompressSource& operator=(const DecompressSource&) = delete;
+
+    // 帧损坏或者没有结束标记时返回 false
+    bool good() const { return good_; }
+    size_t read(void* data, size_t size) override;
+    // 帧头中记录的解压后的总大小，反序列化时据此检查长度
+    uint64_t getSize() const override { return raw_size_; }
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> raw;
+        std::unique_ptr<uint8_t[]> packed;
+        size_t raw_size = 0;
+        size_t packed_size = 0;
+        // 原样存储，不需要解压
+        bool stored = false;
+    };
+
+    // 读入并解压下一批块，没有更多数据时返回 false
+    bool readBlocks();
+
+private:
+    StreamSource& source_;
+    JobSystem* job_system_;
+    size_t block_size_ = 0;
+    uint64_t raw_size_ = 0;
+    // 已经读入的块解压后的大小之和
+    uint64_t decoded_size_ = 0;
+    std::vector<Block> blocks_;
+    uint32_t block_count_ = 0;
+    uint32_t block_index_ = 0;
+    size_t block_offset_ = 0;
+    bool finished_ = false;
+    bool good_ = true;
+};
+
+}  // namespace wen
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/serialize/stream.hpp"
+
+namespace wen {
+
+// 只读映射整个文件，只有访问到的页才会从磁盘读入
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return is_open_; }
+    // 映射的起始地址按页对齐
+    std::span<const uint8_t> getData() const { return {data_, size_}; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool is_open_ = false;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+// 直接从映射的文件中读取，数组和字符串可以返回指向映射内存的视图，不复制
+// 视图在流析构之前有效
+class MappedDeserializeStream final : public DeserializeStream {
+public:
+    explicit MappedDeserializeStream(const std::string& path);
+
+    bool isOpen() const { return file_.isOpen(); }
+    // 整个文件的内容，不影响读取位置
+    std::span<const uint8_t> getMappedData() const { return file_.getData(); }
+
+    // 读取 writeAlignedArray 写入的数组，数据损坏时返回空的视图并标记失败
+    template <typename T>
+    std::span<const T> readArray() {
+        static_assert(is_bulk_serializable_v<T>, "aligned array requires bulk serializable elements");
+        uint64_t count;
+        *this >> count;
+        align(alignof(T));
+        if (!good() || count > getRemaining() / sizeof(T)) {
+            setFailed();
+            return {};
+        }
+        auto data = view(count * sizeof(T));
+        // 映射按页对齐，记录按流中的位置对齐，元素地址一定满足对齐要求
+        return {reinterpret_cast<const T*>(data), static_cast<size_t>(count)};
+    }
+
+    // 读取 std::string 写入的字符串
+    std::string_view readString();
+
+private:
+    MappedFile file_;
+};
+
+}  // namespace wen
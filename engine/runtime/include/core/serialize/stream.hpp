@@ -1,29 +1,84 @@
 #pragma once
 
 #include "core/serialize/serialize.hpp"
+#include "core/serialize/stream_io.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <bit>
+#include <cstring>
+#include <span>
 
 namespace wen {
 
-// 序列化流
+// 数据按本机字节序写入，只支持小端平台，不同平台的文件可以直接交换
+static_assert(std::endian::native == std::endian::little, "serialized data is little-endian");
+
+// 序列化流，按写入顺序排列数据
+// 默认写入内存，缓冲区不够时扩容；指定 StreamSink 时缓冲区写满后交给 sink，占用的内存不超过缓冲区大小
 class SerializeStream {
     friend class DeserializeStream;
 
 public:
+    static constexpr size_t default_buffer_size = 64 << 10;
+
     SerializeStream();
+    explicit SerializeStream(StreamSink& sink, size_t buffer_size = default_buffer_size);
+    // 析构时把缓冲区剩余的数据交给 sink
     ~SerializeStream();
 
+    SerializeStream(const SerializeStream&) = delete;
+    SerializeStream& operator=(const SerializeStream&) = delete;
+
     template <class T>
     std::enable_if_t<std::is_arithmetic_v<T>, void> write(T value) {
-        *reinterpret_cast<T*>(getSafePtr(sizeof(T))) = value;
+        if (static_cast<size_t>(end_ - cursor_) < sizeof(T)) [[unlikely]] {
+            reserve(sizeof(T));
+        }
+        // 数据按字节紧密排列，用 memcpy 避免未对齐的访问
+        std::memcpy(cursor_, &value, sizeof(T));
+        cursor_ += sizeof(T);
     }
 
-    void write(const char* buffer, size_t size);
+    void write(const void* buffer, size_t size) {
+        if (static_cast<size_t>(end_ - cursor_) >= size) [[likely]] {
+            std::memcpy(cursor_, buffer, size);
+            cursor_ += size;
+        } else {
+            writeSlow(buffer, size);
+        }
+    }
+
+    // 写入零字节，使总字节数是 alignment 的倍数
+    void align(size_t alignment) {
+        for (auto padding = (alignment - getSize() % alignment) % alignment; padding > 0; padding--) {
+            write<uint8_t>(0);
+        }
+    }
+
+    // 把缓冲区的数据交给 sink，内存模式下什么都不做
+    bool flush();
+    // sink 写入失败后返回 false
+    bool good() const { return good_; }
+    // 已经写入的总字节数
+    uint64_t getSize() const { return flushed_size_ + static_cast<size_t>(cursor_ - buffer_.get()); }
+
+    // 只用于内存模式
+    std::span<const uint8_t> getData() const { return {buffer_.get(), static_cast<size_t>(cursor_ - buffer_.get())}; }
+    // 只用于内存模式，保留缓冲区以便复用
+    void clear() { cursor_ = buffer_.get(); }
 
 private:
-    void* getSafePtr(size_t size);
+    // 保证缓冲区至少还有 size 字节可写
+    void reserve(size_t size);
+    void writeSlow(const void* buffer, size_t size);
 
 private:
-    std::vector<uint8_t> data_;
+    std::unique_ptr<uint8_t[]> buffer_;
+    uint8_t* cursor_ = nullptr;
+    uint8_t* end_ = nullptr;
+    StreamSink* sink_ = nullptr;
+    uint64_t flushed_size_ = 0;
+    bool good_ = true;
 };
 
 template <class T>
@@ -49,23 +104,88 @@ void SerializeTraits<T>::serialize(SerializeStream& stream, const T& value) {
     stream.write<T>(value);
 }
 
-// 反序列化流
+// 反序列化流，按 SerializeStream 写入的顺序读取
+// 指定 StreamSource 时按缓冲区大小分批读入，读取越界时返回零值并标记失败
 class DeserializeStream {
 public:
+    static constexpr size_t default_buffer_size = 64 << 10;
+
     DeserializeStream(SerializeStream&&);
+    DeserializeStream(std::vector<uint8_t>&& data);
+    explicit DeserializeStream(StreamSource& source, size_t buffer_size = default_buffer_size);
     ~DeserializeStream();
 
+    DeserializeStream(const DeserializeStream&) = delete;
+    DeserializeStream& operator=(const DeserializeStream&) = delete;
+
     template <class T>
     std::enable_if_t<std::is_arithmetic_v<T>, T> read() {
-        offset_ -= sizeof(T);
-        return *reinterpret_cast<T*>(&data_[offset_]);
+        T value;
+        if (static_cast<size_t>(end_ - cursor_) >= sizeof(T)) [[likely]] {
+            std::memcpy(&value, cursor_, sizeof(T));
+            cursor_ += sizeof(T);
+        } else {
+            readSlow(&value, sizeof(T));
+        }
+        return value;
+    }
+
+    void read(void* buffer, size_t size) {
+        if (static_cast<size_t>(end_ - cursor_) >= size) [[likely]] {
+            std::memcpy(buffer, cursor_, size);
+            cursor_ += size;
+        } else {
+            readSlow(buffer, size);
+        }
+    }
+
+    void skip(size_t size);
+    // 跳过 SerializeStream::align 写入的填充字节
+    void align(size_t alignment) { skip((alignment - getPosition() % alignment) % alignment); }
+
+    // 接下来的 size 字节已经在连续的内存中时返回指向它们的指针并跳过，否则返回 nullptr 并且不读取
+    // 内存模式下指针一直有效，指定 StreamSource 时只在下一次读取之前有效
+    const uint8_t* view(size_t size) {
+        if (static_cast<size_t>(end_ - cursor_) < size) {
+            return nullptr;
+        }
+        auto data = cursor_;
+        cursor_ += size;
+        return data;
     }
 
-    void read(void* buffer, size_t size);
+    // 读取越界或者 source 出错后返回 false
+    bool good() const { return good_; }
+    // 数据损坏时由反序列化代码标记失败
+    void setFailed() { good_ = false; }
+    // 已经读取的字节数
+    uint64_t getPosition() const { return buffer_offset_ + static_cast<size_t>(cursor_ - begin_); }
+    // 剩余未读取的字节数，source 不知道大小时返回 StreamSource::unknown_size
+    uint64_t getRemaining() const;
+
+protected:
+    DeserializeStream() = default;
+
+    // 读取外部的内存，不复制
+    void setData(std::span<const uint8_t> data);
+
+private:
+    void readSlow(void* buffer, size_t size);
+    // 从 source 读入下一批数据，没有数据时返回 false
+    bool refill();
 
 private:
-    size_t offset_;
+    std::unique_ptr<uint8_t[]> buffer_;
     std::vector<uint8_t> data_;
+    size_t buffer_size_ = 0;
+    const uint8_t* begin_ = nullptr;
+    const uint8_t* cursor_ = nullptr;
+    const uint8_t* end_ = nullptr;
+    StreamSource* source_ = nullptr;
+    uint64_t total_size_ = 0;
+    // begin_ 在整个流中的位置
+    uint64_t buffer_offset_ = 0;
+    bool good_ = true;
 };
 
 template <class T>
@@ -85,77 +205,264 @@ void SerializeTraits<T>::deserialize(DeserializeStream& stream, T& value) {
     value = stream.read<T>();
 }
 
+// 生成的反序列化代码读完所有成员之后调用，有 onPropertyChanged 的类型（例如 RTTI）同步依赖成员的状态
+template <class T>
+void notifyPropertyChanged(T& value) {
+    if constexpr (requires { value.onPropertyChanged(); }) {
+        value.onPropertyChanged();
+    }
+}
+
+// 序列化的字节与内存中的字节完全相同的类型，数组可以用一次 memcpy 整体读写
+// 要求平凡复制，逐个元素写入和整体写入的结果相同，所以两种写法的文件可以互相读取
+// 流中的数据不保证对齐，整体读写也只通过 memcpy 访问
+template <typename T>
+struct BulkSerializable : std::bool_constant<std::is_arithmetic_v<T>> {};
+
+template <glm::length_t L, typename T, glm::qualifier Q>
+struct BulkSerializable<glm::vec<L, T, Q>> : std::bool_constant<std::is_arithmetic_v<T>> {};
+
+template <glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+struct BulkSerializable<glm::mat<C, R, T, Q>> : std::bool_constant<std::is_arithmetic_v<T>> {};
+
+template <typename T, glm::qualifier Q>
+struct BulkSerializable<glm::qua<T, Q>> : std::bool_constant<std::is_arithmetic_v<T>> {};
+
+template <typename T, size_t N>
+struct BulkSerializable<std::array<T, N>> : BulkSerializable<T> {};
+
+template <typename T>
+inline constexpr bool is_bulk_serializable_v = [] {
+    // parser.py 为成员都可以整体读写并且没有填充字节的 SERIALIZABLE_CLASS 生成 bulk_serializable
+    if constexpr (requires { SerializeTraits<T>::bulk_serializable; }) {
+        return SerializeTraits<T>::bulk_serializable;
+    } else {
+        return BulkSerializable<T>::value;
+    }
+}();
+
+// 一个元素在流中至少占用的字节数，用于在分配内存之前检查损坏的元素个数
+// 容器类型在 SerializeTraits 中声明 min_serialized_size，其他类型按一个字节计算
+template <typename T>
+inline constexpr size_t min_serialized_size_v = [] {
+    if constexpr (is_bulk_serializable_v<T>) {
+        return sizeof(T);
+    } else if constexpr (requires { SerializeTraits<T>::min_serialized_size; }) {
+        return SerializeTraits<T>::min_serialized_size;
+    } else {
+        return size_t(1);
+    }
+}();
+
+template <typename T>
+void serializeElements(SerializeStream& stream, const T* values, size_t count) {
+    if constexpr (is_bulk_serializable_v<T>) {
+        // 空数组的指针可能为空
+        if (count > 0) {
+            stream.write(values, count * sizeof(T));
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            stream << values[i];
+        }
+    }
+}
+
+template <typename T>
+void deserializeElements(DeserializeStream& stream, T* values, size_t count) {
+    if constexpr (is_bulk_serializable_v<T>) {
+        if (count > 0) {
+            stream.read(values, count * sizeof(T));
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            stream >> values[i];
+        }
+    }
+}
+
+// 对齐的数组记录：元素个数，填充到 alignof(T) 的零字节，按内存布局整体写入的元素
+// 流从文件开头写入时，MappedDeserializeStream 可以直接返回指向映射内存的 span
+template <typename T>
+void writeAlignedArray(SerializeStream& stream, std::span<const T> values) {
+    static_assert(is_bulk_serializable_v<T>, "aligned array requires bulk serializable elements");
+    stream << static_cast<uint64_t>(values.size());
+    stream.align(alignof(T));
+    if (!values.empty()) {
+        stream.write(values.data(), values.size_bytes());
+    }
+}
+
+template <typename T>
+bool readAlignedArray(DeserializeStream& stream, std::vector<T>& values) {
+    static_assert(is_bulk_serializable_v<T>, "aligned array requires bulk serializable elements");
+    uint64_t count;
+    stream >> count;
+    stream.align(alignof(T));
+    if (!stream.good() || count > stream.getRemaining() / sizeof(T)) {
+        stream.setFailed();
+        return false;
+    }
+    values.resize(count);
+    if (count > 0) {
+        stream.read(values.data(), count * sizeof(T));
+    }
+    return stream.good();
+}
+
 // std::string
 template <>
 struct SerializeTraits<std::string> {
+    static constexpr size_t min_serialized_size = sizeof(std::string::size_type);
+
     static void serialize(SerializeStream& stream, const std::string& value) {
-        stream.write(value.data(), value.length());  
         stream << value.length();
+        stream.write(value.data(), value.length());
     }
 
     static void deserialize(DeserializeStream& stream, std::string& value) {
         std::string::size_type length;
         stream >> length;
+        // 长度损坏时不分配内存
+        if (length > stream.getRemaining()) {
+            stream.setFailed();
+            value.clear();
+            return;
+        }
         value.resize(length);
         stream.read(value.data(), length);
     }
 };
 
+// glm 的向量、矩阵和四元数按内存布局整体写入
+template <glm::length_t L, typename T, glm::qualifier Q>
+struct SerializeTraits<glm::vec<L, T, Q>> {
+    static void serialize(SerializeStream& stream, const glm::vec<L, T, Q>& value) {
+        stream.write(&value, sizeof(value));
+    }
+
+    static void deserialize(DeserializeStream& stream, glm::vec<L, T, Q>& value) {
+        stream.read(&value, sizeof(value));
+    }
+};
+
+template <glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+struct SerializeTraits<glm::mat<C, R, T, Q>> {
+    static void serialize(SerializeStream& stream, const glm::mat<C, R, T, Q>& value) {
+        stream.write(&value, sizeof(value));
+    }
+
+    static void deserialize(DeserializeStream& stream, glm::mat<C, R, T, Q>& value) {
+        stream.read(&value, sizeof(value));
+    }
+};
+
+template <typename T, glm::qualifier Q>
+struct SerializeTraits<glm::qua<T, Q>> {
+    static void serialize(SerializeStream& stream, const glm::qua<T, Q>& value) {
+        stream.write(&value, sizeof(value));
+    }
+
+    static void deserialize(DeserializeStream& stream, glm::qua<T, Q>& value) {
+        stream.read(&value, sizeof(value));
+    }
+};
+
 // std::vector<T>
 template <typename T>
 struct SerializeTraits<std::vector<T>> {
+    static constexpr size_t min_serialized_size = 2 * sizeof(size_t);
+
     static void serialize(SerializeStream& stream, const std::vector<T>& value) {
-        auto capacity = value.capacity();
-        auto size = value.size();
-        for (size_t i = 0; i < size; i++) {
-            stream << value[size - i - 1];
-        }
-        stream << capacity << size;
+        stream << value.size() << value.capacity();
+        serializeElements(stream, value.data(), value.size());
     }
 
     static void deserialize(DeserializeStream& stream, std::vector<T>& value) {
-        size_t capacity, size;
+        size_t size, capacity;
         stream >> size >> capacity;
-        value.reserve(capacity);
+        if (!stream.good()) {
+            return;
+        }
+        // 大小损坏时不分配内存，capacity 来自文件，不用于分配
+        if (size > stream.getRemaining() / min_serialized_size_v<T>) {
+            stream.setFailed();
+            return;
+        }
         value.resize(size);
-        for (size_t i = 0; i < size; i++) {
-            stream >> value[i];
+        deserializeElements(stream, value.data(), size);
+    }
+};
+
+// std::array<T, N>，长度在类型中，不写入
+template <typename T, size_t N>
+struct SerializeTraits<std::array<T, N>> {
+    static void serialize(SerializeStream& stream, const std::array<T, N>& value) {
+        serializeElements(stream, value.data(), N);
+    }
+
+    static void deserialize(DeserializeStream& stream, std::array<T, N>& value) {
+        deserializeElements(stream, value.data(), N);
+    }
+};
+
+// std::span<T>，与 std::vector 不同，只写入元素个数
+// 读取到已有的内存中，元素个数不符时标记失败
+template <typename T, size_t Extent>
+struct SerializeTraits<std::span<T, Extent>> {
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
+    static void serialize(SerializeStream& stream, const std::span<T, Extent>& value) {
+        stream << value.size();
+        serializeElements(stream, value.data(), value.size());
+    }
+
+    static void deserialize(DeserializeStream& stream, std::span<T, Extent>& value) {
+        size_t size;
+        stream >> size;
+        if (size != value.size()) {
+            stream.setFailed();
+            return;
         }
+        deserializeElements(stream, value.data(), size);
     }
 };
 
 // std::pair<T1, T2>
 template <typename T1, typename T2>
 struct SerializeTraits<std::pair<T1, T2>> {
+    static constexpr size_t min_serialized_size = min_serialized_size_v<T1> + min_serialized_size_v<T2>;
+
     static void serialize(SerializeStream& stream, const std::pair<T1, T2>& value) {
         stream << value.first << value.second;
     }
 
     static void deserialize(DeserializeStream& stream, std::pair<T1, T2>& value) {
-        stream >> value.second >> value.first;
+        stream >> value.first >> value.second;
     }
 };
 
 // std::map<T1, T2>
 template <typename T1, typename T2>
 struct SerializeTraits<std::map<T1, T2>> {
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
     static void serialize(SerializeStream& stream, const std::map<T1, T2>& value) {
-        auto size = value.size();
+        stream << value.size();
         for (auto& pair : value) {
             stream << pair;
         }
-        stream << size;
     }
 
     static void deserialize(DeserializeStream& stream, std::map<T1, T2>& value) {
         size_t size;
         stream >> size;
         std::pair<T1, T2> pair;
-        for (size_t i = 0; i < size; i++) {
+        for (size_t i = 0; i < size && stream.good(); i++) {
             stream >> pair;
             value.insert(std::move(pair));
         }
     }
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
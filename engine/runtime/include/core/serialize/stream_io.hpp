@@ -0,0 +1,174 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace wen {
+
+// 序列化流写出字节的目标
+class StreamSink {
+public:
+    virtual ~StreamSink() = default;
+
+    // 出错时返回 false
+    virtual bool write(const void* data, size_t size) = 0;
+    virtual bool flush() { return true; }
+};
+
+// 反序列化流读入字节的来源
+class StreamSource {
+public:
+    static constexpr uint64_t unknown_size = std::numeric_limits<uint64_t>::max();
+
+    virtual ~StreamSource() = default;
+
+    // 最多读取 size 字节，返回实际读取的字节数，返回 0 表示已经读完或者出错
+    virtual size_t read(void* data, size_t size) = 0;
+    // 总字节数，未知时返回 unknown_size
+    virtual uint64_t getSize() const { return unknown_size; }
+};
+
+// 追加到外部的数组
+class MemorySink final : public StreamSink {
+public:
+    explicit MemorySink(std::vector<uint8_t>& data) : data_(data) {}
+
+    bool write(const void* data, size_t size) override {
+        auto bytes = static_cast<const uint8_t*>(data);
+        data_.insert(data_.end(), bytes, bytes + size);
+        return true;
+    }
+
+private:
+    std::vector<uint8_t>& data_;
+};
+
+// 读取外部的内存，不复制
+class MemorySource final : public StreamSource {
+public:
+    explicit MemorySource(std::span<const uint8_t> data) : data_(data) {}
+
+    size_t read(void* data, size_t size) override;
+    uint64_t getSize() const override { return data_.size(); }
+
+private:
+    std::span<const uint8_t> data_;
+    size_t offset_ = 0;
+};
+
+class FileSink final : public StreamSink {
+public:
+    explicit FileSink(const std::string& path);
+
+    bool isOpen() const { return file_.is_open(); }
+    bool write(const void* data, size_t size) override;
+    bool flush() override;
+
+private:
+    std::ofstream file_;
+};
+
+class FileSource final : public StreamSource {
+public:
+    explicit FileSource(const std::string& path);
+
+    bool isOpen() const { return file_.is_open(); }
+    size_t read(void* data, size_t size) override;
+    uint64_t getSize() const override { return size_; }
+
+private:
+    std::ifstream file_;
+    uint64_t size_ = 0;
+};
+
+// 固定数量的块组成的环形缓冲区，一个线程写入，另一个线程读取
+// 缓冲区写满时写入方等待，读完时读取方等待，占用的内存不超过 chunk_size * chunk_count
+class StreamPipe {
+public:
+    StreamPipe(size_t chunk_size, uint32_t chunk_count);
+
+    StreamPipe(const StreamPipe&) = delete;
+    StreamPipe& operator=(const StreamPipe&) = delete;
+
+    // 写入方调用，读取方取消后返回 false
+    bool write(const void* data, size_t size);
+    // 写入方调用，提交没有写满的块，之后读取方读完剩余的数据后结束
+    void close();
+
+    // 读取方调用，返回 0 表示写入方已经关闭并且数据全部读完
+    size_t read(void* data, size_t size);
+    // 读取方调用，不再读取，之后的写入直接失败
+    void cancel();
+
+private:
+    struct Chunk {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+    };
+
+    bool commit();
+
+private:
+    size_t chunk_size_;
+    std::vector<Chunk> chunks_;
+    // 只由写入方访问，正在写入的块
+    size_t write_offset_ = 0;
+    // 只由读取方访问，正在读取的块中已经读取的字节数
+    size_t read_offset_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    // 已经提交和已经读完的块数，对块数取模得到位置
+    uint64_t committed_count_ = 0;
+    uint64_t consumed_count_ = 0;
+    bool closed_ = false;
+    bool cancelled_ = false;
+};
+
+class PipeSink final : public StreamSink {
+public:
+    explicit PipeSink(StreamPipe& pipe) : pipe_(pipe) {}
+
+    bool write(const void* data, size_t size) override { return pipe_.write(data, size); }
+
+private:
+    StreamPipe& pipe_;
+};
+
+class PipeSource final : public StreamSource {
+public:
+    explicit PipeSource(StreamPipe& pipe) : pipe_(pipe) {}
+
+    size_t read(void* data, size_t size) override { return pipe_.read(data, size); }
+
+private:
+    StreamPipe& pipe_;
+};
+
+// 在后台线程上按块预读文件，读取方可以在文件读完之前开始解码
+class AsyncFileSource final : public StreamSource {
+public:
+    static constexpr size_t default_chunk_size = 1 << 20;
+    static constexpr uint32_t default_chunk_count = 4;
+
+    explicit AsyncFileSource(const std::string& path, size_t chunk_size = default_chunk_size, uint32_t chunk_count = default_chunk_count);
+    // 没有读完时取消预读
+    ~AsyncFileSource() override;
+
+    bool isOpen() const { return file_.isOpen(); }
+    size_t read(void* data, size_t size) override { return pipe_.read(data, size); }
+    uint64_t getSize() const override { return file_.getSize(); }
+
+private:
+    FileSource file_;
+    StreamPipe pipe_;
+    std::thread thread_;
+};
+
+}  // namespace wen
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/serialize/stream.hpp"
+#include "core/reflect/name_hash.hpp"
+
+namespace wen {
+
+// 带标签的格式，类的成员改变后仍然可以读取旧的数据，由 parser.py 为每个 SERIALIZABLE_CLASS 生成 serializeTagged 和 deserializeTagged
+// 每个对象写成一个块：
+//   uint64 结构哈希，uint64 之后的字节数，uint32 字段数，字段表 (uint64 字段 ID，uint64 字节数)，按声明顺序排列的字段数据
+// 字段 ID 是成员类型和名字的哈希，字段数据与不带标签的格式相同，父类是嵌套的块
+// 结构哈希相同时跳过字段表按位置读取，不同时按字段表逐个读取，不认识的字段和整个块都可以直接跳过
+struct TaggedField {
+    NameID id;
+    uint64_t size;
+};
+
+// 把成员类型的结构哈希合并到类的结构哈希中，成员的类改变时外层的类也按结构改变处理
+constexpr uint64_t combineSchemaHash(uint64_t seed, std::initializer_list<uint64_t> values) {
+    for (auto value : values) {
+        for (int i = 0; i < 8; i++) {
+            seed ^= static_cast<uint8_t>(value >> (i * 8));
+            seed *= 0x100000001b3ull;
+        }
+    }
+    return seed;
+}
+
+// 类型的结构哈希，parser.py 生成的类使用自身的 schema_hash，容器使用元素的结构哈希，其他类型为 0
+// parser.py 按成员类型的依赖顺序生成，成员的类总是先于外层的类生成
+template <typename T>
+struct SchemaHash {
+    static constexpr uint64_t value = [] {
+        if constexpr (requires { SerializeTraits<T>::schema_hash; }) {
+            return SerializeTraits<T>::schema_hash;
+        } else {
+            return uint64_t(0);
+        }
+    }();
+};
+
+template <typename T>
+struct SchemaHash<std::vector<T>> : SchemaHash<T> {};
+
+template <typename T, size_t N>
+struct SchemaHash<std::array<T, N>> : SchemaHash<T> {};
+
+template <typename T1, typename T2>
+struct SchemaHash<std::pair<T1, T2>> {
+    static constexpr uint64_t value = combineSchemaHash(SchemaHash<T1>::value, {SchemaHash<T2>::value});
+};
+
+template <typename T1, typename T2>
+struct SchemaHash<std::map<T1, T2>> : SchemaHash<std::pair<T1, T2>> {};
+
+// 生成的 serializeTagged 使用，字段数据先写入当前线程的临时缓冲区，结束时连同字段表一起写入
+class TaggedWriter {
+public:
+    TaggedWriter(SerializeStream& stream, uint64_t schema_hash);
+    ~TaggedWriter();
+
+    TaggedWriter(const TaggedWriter&) = delete;
+    TaggedWriter& operator=(const TaggedWriter&) = delete;
+
+    template <typename T>
+    void field(NameID id, const T& value) {
+        auto begin = data_->getSize();
+        *data_ << value;
+        fields_->push_back({id, data_->getSize() - begin});
+    }
+
+    template <typename T>
+    void parent(NameID id, const T& value) {
+        auto begin = data_->getSize();
+        SerializeTraits<T>::serializeTagged(*data_, value);
+        fields_->push_back({id, data_->getSize() - begin});
+    }
+
+    void finish();
+
+    // 所有字段都可以整体读写的类直接写入对象的字节，不经过临时缓冲区
+    static void writeBulk(SerializeStream& stream, uint64_t schema_hash, std::span<const TaggedField> fields, const void* data, size_t size);
+
+private:
+    SerializeStream& stream_;
+    uint64_t schema_hash_;
+    // 嵌套的块使用各自的缓冲区，缓冲区在线程内复用
+    SerializeStream* data_;
+    std::vector<TaggedField>* fields_;
+};
+
+// 生成的 deserializeTagged 使用
+class TaggedReader {
+public:
+    // 读取块头，数据损坏时标记失败
+    explicit TaggedReader(DeserializeStream& stream);
+
+    TaggedReader(const TaggedReader&) = delete;
+    TaggedReader& operator=(const TaggedReader&) = delete;
+
+    // 结构哈希相同时跳过字段表，之后按位置读取所有字段
+    // 不同时读入字段表，之后用 nextField 逐个读取
+    bool matches(uint64_t schema_hash);
+    // 跳到下一个字段的开头，没有更多字段时返回 false
+    bool nextField();
+    NameID getFieldID() const { return field_id_; }
+    // 跳过剩余的数据，读取越过块的结尾时标记失败
+    bool finish();
+
+private:
+    DeserializeStream& stream_;
+    uint64_t schema_hash_ = 0;
+    uint32_t field_count_ = 0;
+    uint64_t block_end_ = 0;
+    std::vector<TaggedField> fields_;
+    uint32_t field_index_ = 0;
+    uint64_t field_end_ = 0;
+    NameID field_id_ = 0;
+};
+
+template <typename T>
+void serializeTagged(SerializeStream& stream, const T& value) {
+    SerializeTraits<T>::serializeTagged(stream, value);
+}
+
+template <typename T>
+bool deserializeTagged(DeserializeStream& stream, T& value) {
+    SerializeTraits<T>::deserializeTagged(stream, value);
+    return stream.good();
+}
+
+// 不读取内容，跳过一个块，用于不认识的类
+bool skipTagged(DeserializeStream& stream);
+
+}  // namespace wen
@@ -12,7 +12,7 @@ public:
     Engine(Engine&&) = delete;
     ~Engine() = default;
 
-    void startupEngine();
+    void startupEngine(const EngineConfiguration& config = {});
     void shutdownEngine();
 
     void runEngine();
@@ -22,16 +22,29 @@ public:
     void stopTimer();
 
 protected:
+    bool shouldExit() const;
+    // 逻辑线程: 模拟一帧并发布渲染快照
     void tickOneFrame();
     void tickLogic();
-    void tickRender();
+    // 渲染线程: 消费快照，录制并提交
+    void renderLoop();
+    void tickRender(const RenderSnapshot& snapshot);
+    void reportHeadlessTimings() const;
 
 private:
+    struct FrameTiming {
+        float logic_ms;
+        float render_ms;
+    };
+
+    EngineConfiguration config_;
+    uint32_t frame_index_ = 0;
+    std::vector<FrameTiming> frame_timings_;
     float delta_time_;
+    float fixed_tick_accumulator_;
     std::shared_ptr<Timer> main_timer_;
-    std::shared_ptr<Timer> fixed_timer_;
-    std::shared_ptr<Timer> benchmark_timer_;
-    std::unique_ptr<std::thread> fixed_tick_thread_;
+    std::unique_ptr<RenderSnapshotQueue> snapshot_queue_;
+    std::unique_ptr<std::thread> render_thread_;
 };
 
 }  // namespace wen
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/log/log_system.hpp"
+#include "core/profile/profile_system.hpp"
+#include "core/job/job_system.hpp"
 #include "function/window/window_system.hpp"
 #include "function/event/event_system.hpp"
 #include "function/input/input_system.hpp"
@@ -8,17 +10,33 @@
 #include "core/reflect/reflect_system.hpp"
 #include "function/render/render_system.hpp"
 #include "function/framework/uuid_manager.hpp"
+#include "function/framework/scene_serializer.hpp"
 #include "function/framework/scene_manager.hpp"
 #include "function/asset/asset_system.hpp"
 #include "function/camera/camera_system.hpp"
 
 namespace wen {
 
+struct EngineConfiguration {
+    WindowInfo window_info{"wen 16 : 9", 1600, 900};
+    bool debug = true;
+    bool enable_ray_tracing = true;
+    // 无窗口模式：运行 headless_frame_count 帧后退出，并输出每帧 CPU 耗时
+    bool headless = false;
+    uint32_t headless_frame_count = 1000;
+    // 非空时记录整个运行过程，结束后导出 chrome trace json
+    std::string profile_trace_filename;
+    // GPU 计时之外额外记录管线统计计数
+    bool enable_pipeline_statistics = false;
+};
+
 struct GlobalContext {
-    void startup();
+    void startup(const EngineConfiguration& config = {});
     void shutdown();
 
     Singleton<LogSystem> log_system;
+    Singleton<ProfileSystem> profile_system;
+    Singleton<JobSystem> job_system;
     Singleton<WindowSystem> window_system;
     Singleton<EventSystem> event_system;
     Singleton<InputSystem> input_system;
@@ -27,6 +45,7 @@ struct GlobalContext {
     Singleton<RenderSystem> render_system;
     Singleton<GameObjectUUIDAllocator> game_object_uuid_allocator;
     Singleton<ComponentTypeUUIDSystem> component_type_uuid_system;
+    Singleton<SceneSerializer> scene_serializer;
     Singleton<SceneManager> scene_manager;
     Singleton<AssetSystem> asset_system;
     Singleton<CameraSystem> camera_system;
@@ -14,6 +14,8 @@ public:
     void setRootDir(const std::string& path) { path_ = path; }
 
     MeshID loadMesh(const std::string& filename, const std::vector<std::string>& lods = {});
+    // 只解析 obj 文件生成 MeshData，不上传到 GPU
+    static bool importMesh(const std::string& filepath, const std::vector<std::string>& lods, MeshData& data);
 
     auto getMaxPrimitiveCount() const { return 4096; }
     auto getMaxMeshCount() const { return 1024; }
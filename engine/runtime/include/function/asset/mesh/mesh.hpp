@@ -21,4 +21,11 @@ struct MeshDescriptor {
     alignas(4) float pad;
 };
 
+// MeshDescriptor 中包围体的 CPU 副本，radius 为顶点到原点的最大距离
+struct MeshBounds {
+    glm::vec3 aabb_min;
+    glm::vec3 aabb_max;
+    float radius;
+};
+
 }  // namespace wen
\ No newline at end of file
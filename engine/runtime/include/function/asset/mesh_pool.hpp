@@ -13,6 +13,8 @@ public:
     MeshID uploadMeshData(const MeshData& mesh_data);
     auto getMeshCount() const { return current_mesh_descriptor_count; }
     auto getPrimitiveCount() const { return current_primitive_descriptor_count; }
+    // 不读取映射的 GPU 内存，mesh_id 无效时返回 nullptr
+    const MeshBounds* getMeshBounds(MeshID mesh_id) const { return mesh_id < mesh_bounds.size() ? &mesh_bounds[mesh_id] : nullptr; }
 
 public:
     uint32_t current_vertex_count;
@@ -33,6 +35,7 @@ public:
     std::shared_ptr<Renderer::Buffer> mesh_descriptor_buffer;
     MeshDescriptor* mesh_descriptor_buffer_ptr;
     uint32_t current_mesh_descriptor_count;
+    std::vector<MeshBounds> mesh_bounds;
 };
 
 }  // namespace wen
\ No newline at end of file
@@ -40,11 +40,19 @@ public:
     auto getClipCamera() { return clip_camera_; }
     bool isFixedClip() const { return fixed_clip_; }
 
+    // 逻辑线程写入的相机数据，由渲染快照拷贝后再上传
+    const CameraData& getViewportCameraData() const { return viewport_camera_data_; }
+    const CameraData& getClipCameraData() const { return clip_camera_data_; }
+    // 渲染线程调用，将快照中的相机数据写入 uniform buffer
+    void upload(const CameraData& viewport_camera, const CameraData& clip_camera);
+
 private:
     std::map<CameraID, CameraData> cameras_;
     CameraID current_camera_id_;
     std::shared_ptr<Renderer::UniformBuffer> viewport_camera_;
     std::shared_ptr<Renderer::UniformBuffer> clip_camera_;
+    CameraData viewport_camera_data_;
+    CameraData clip_camera_data_;
     CameraID current_primary_viewport_;
     bool fixed_clip_;
     bool editor_camera_active_;
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "function/framework/uuid_manager.hpp"
+#include "function/framework/command_sort_key.hpp"
+#include "core/job/job_system.hpp"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace wen {
+
+class Component;
+class GameObject;
+
+// 组件类型的内存布局和生命周期操作，组件在存储中只能通过这些函数移动和析构
+struct ComponentTypeInfo {
+    ComponentTypeUUID uuid;
+    uint32_t size;
+    uint32_t alignment;
+    const std::type_info* type;
+    void (*move_construct)(void* dst, void* src);
+    void (*destroy)(void* ptr);
+    Component* (*to_component)(void* ptr);
+
+    template <class C>
+    static ComponentTypeInfo create(ComponentTypeUUID uuid) {
+        static_assert(std::is_move_constructible_v<C>, "component must be move constructible");
+        return ComponentTypeInfo{
+            .uuid = uuid,
+            .size = static_cast<uint32_t>(sizeof(C)),
+            .alignment = static_cast<uint32_t>(alignof(C)),
+            .type = &typeid(C),
+            .move_construct = [](void* dst, void* src) { new (dst) C(std::move(*static_cast<C*>(src))); },
+            .destroy = [](void* ptr) { static_cast<C*>(ptr)->~C(); },
+            .to_component = [](void* ptr) -> Component* { return static_cast<C*>(ptr); },
+        };
+    }
+};
+
+// 一种组件类型在某个 archetype 中的连续存储，按块分配，扩容时已有组件的地址不变
+class ComponentColumn {
+public:
+    ComponentColumn(const ComponentTypeInfo& info) : info_(info) {}
+    ComponentColumn(ComponentColumn&& rhs) noexcept;
+    ~ComponentColumn();
+
+    void allocateChunk(uint32_t row_count);
+    void* getChunk(uint32_t chunk) const { return chunks_[chunk]; }
+    void* get(uint32_t row, uint32_t chunk_row_count) const {
+        return chunks_[row / chunk_row_count] + static_cast<size_t>(row % chunk_row_count) * info_.size;
+    }
+    const ComponentTypeInfo& getInfo() const { return info_; }
+
+private:
+    ComponentTypeInfo info_;
+    std::vector<uint8_t*> chunks_;
+};
+
+// 拥有相同组件类型集合的 GameObject 存放在同一个 archetype 中，每种组件一列
+// 删除的行留空并在之后复用，不移动其他行，所以组件地址只在自己所属 GameObject 的组件集合变化时改变
+class Archetype {
+    friend class ArchetypeStorage;
+
+public:
+    static constexpr uint32_t chunk_row_count = 1024;
+    static constexpr uint32_t invalid_column = std::numeric_limits<uint32_t>::max();
+
+    Archetype(std::vector<ComponentTypeInfo> infos);
+
+    uint32_t allocateRow(GameObject* game_object);
+    void reserveRows(uint32_t count) { game_objects_.reserve(game_objects_.size() + count); }
+    void freeRow(uint32_t row);
+
+    // 通过 uuid 直接索引列下标，不存在时为 invalid_column
+    uint32_t findColumn(ComponentTypeUUID uuid) const {
+        return uuid < column_index_.size() ? column_index_[uuid] : invalid_column;
+    }
+    void* getComponent(uint32_t column, uint32_t row) const { return columns_[column].get(row, chunk_row_count); }
+    Component* getComponentBase(uint32_t column, uint32_t row) const {
+        return columns_[column].getInfo().to_component(getComponent(column, row));
+    }
+
+    const std::vector<ComponentTypeUUID>& getTypes() const { return types_; }
+    const std::vector<ComponentColumn>& getColumns() const { return columns_; }
+    GameObject* getGameObject(uint32_t row) const { return game_objects_[row]; }
+    uint32_t getRowCount() const { return static_cast<uint32_t>(game_objects_.size()); }
+    uint32_t getAliveCount() const { return alive_count_; }
+
+    uint32_t getChunkCount() const { return (getRowCount() + chunk_row_count - 1) / chunk_row_count; }
+
+    // 遍历一个块中存活的行，fn(GameObject*, Cs&...) 或 fn(Cs&...)
+    template <class... Cs, typename F, size_t... I>
+    void eachChunk(const uint32_t* columns, uint32_t chunk, F& fn, std::index_sequence<I...>) {
+        std::tuple<Cs*...> bases{static_cast<Cs*>(columns_[columns[I]].getChunk(chunk))...};
+        uint32_t begin = chunk * chunk_row_count;
+        uint32_t end = std::min(getRowCount(), begin + chunk_row_count);
+        for (uint32_t row = begin; row < end; row++) {
+            auto* game_object = game_objects_[row];
+            if (game_object == nullptr) {
+                continue;
+            }
+            if constexpr (std::is_invocable_v<F&, GameObject*, Cs&...>) {
+                fn(game_object, std::get<I>(bases)[row - begin]...);
+            } else {
+                fn(std::get<I>(bases)[row - begin]...);
+            }
+        }
+    }
+
+private:
+    std::vector<ComponentTypeUUID> types_;  // 已排序
+    std::vector<ComponentColumn> columns_;
+    std::vector<uint32_t> column_index_;    // uuid -> 列下标
+    std::vector<GameObject*> game_objects_;  // 空行为 nullptr
+    std::vector<uint32_t> free_rows_;
+    uint32_t alive_count_ = 0;
+    // 增加或删除一种组件后的目标 archetype，nullptr 表示没有组件
+    std::unordered_map<ComponentTypeUUID, Archetype*> add_edges_;
+    std::unordered_map<ComponentTypeUUID, Archetype*> remove_edges_;
+};
+
+// GameObject 在存储中的位置，archetype 为 nullptr 时没有任何组件
+struct EntityLocation {
+    Archetype* archetype = nullptr;
+    uint32_t row = 0;
+};
+
+// 每个 Scene 一份，按组件类型集合组织所有组件
+class ArchetypeStorage {
+public:
+    ArchetypeStorage() = default;
+    ~ArchetypeStorage();
+
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    // 把 src 移动到存储中并返回新地址，src 之后由调用者析构
+    Component* insertComponent(GameObject* game_object, EntityLocation& location, const ComponentTypeInfo& info, void* src);
+    // 一次加入多个组件，GameObject 直接移动到最终的 archetype，组件类型不能重复
+    void insertComponents(GameObject* game_object, EntityLocation& location, const ComponentTypeInfo* infos, void* const* srcs, Component** results, size_t count);
+    // 把一组没有组件的 GameObject 放入 infos 对应的 archetype，只分配行，不构造组件
+    // 调用者必须在其他操作之前在每一行上构造所有列的组件
+    Archetype* allocateRows(const std::vector<ComponentTypeInfo>& infos, GameObject* const* game_objects, uint32_t count, EntityLocation* locations);
+    // 析构并移除一个组件，其余组件移动到新的 archetype
+    void eraseComponent(EntityLocation& location, ComponentTypeUUID uuid);
+    // 析构该位置上的所有组件
+    void erase(EntityLocation& location);
+
+    Component* getComponent(const EntityLocation& location, ComponentTypeUUID uuid) const;
+
+    // 遍历同时拥有 Cs... 的所有 GameObject
+    template <class... Cs, typename F>
+    void each(F&& fn) {
+        static_assert(sizeof...(Cs) > 0);
+        const ComponentTypeUUID uuids[] = {ComponentTypeUUIDSystem::get<Cs>()...};
+        uint32_t columns[sizeof...(Cs)];
+        // 遍历过程中可能创建新的 archetype，按下标访问
+        for (size_t i = 0; i < archetypes_.size(); i++) {
+            auto* archetype = archetypes_[i].get();
+            if (archetype->getAliveCount() == 0 || !findColumns(archetype, uuids, columns, sizeof...(Cs))) {
+                continue;
+            }
+            for (uint32_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+                archetype->eachChunk<Cs...>(columns, chunk, fn, std::index_sequence_for<Cs...>{});
+            }
+        }
+    }
+
+    // 与 each 相同，但以块为单位在工作线程上并行执行，fn 会被多个线程同时调用
+    template <class... Cs, typename F>
+    void parallelEach(JobSystem& job_system, F&& fn) {
+        static_assert(sizeof...(Cs) > 0);
+        const ComponentTypeUUID uuids[] = {ComponentTypeUUIDSystem::get<Cs>()...};
+        struct ChunkTask {
+            Archetype* archetype;
+            uint32_t chunk;
+            std::array<uint32_t, sizeof...(Cs)> columns;
+        };
+        std::vector<ChunkTask> tasks;
+        for (const auto& archetype : archetypes_) {
+            ChunkTask task{archetype.get(), 0, {}};
+            if (archetype->getAliveCount() == 0 || !findColumns(archetype.get(), uuids, task.columns.data(), sizeof...(Cs))) {
+                continue;
+            }
+            for (; task.chunk < archetype->getChunkCount(); task.chunk++) {
+                tasks.push_back(task);
+            }
+        }
+        // 每个块使用独立的排序键，块内记录的命令回放顺序固定
+        uint64_t sort_key = CommandSortKey::current();
+        job_system.parallelFor<size_t>(0, tasks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                CommandSortKey::Scope scope(sort_key | (i + 1));
+                tasks[i].archetype->template eachChunk<Cs...>(tasks[i].columns.data(), tasks[i].chunk, fn, std::index_sequence_for<Cs...>{});
+            }
+        });
+    }
+
+    // 按 archetype、列、行的顺序遍历所有组件
+    template <typename F>
+    void forEachComponent(F&& fn) {
+        for (size_t i = 0; i < archetypes_.size(); i++) {
+            auto* archetype = archetypes_[i].get();
+            if (archetype->getAliveCount() == 0) {
+                continue;
+            }
+            for (uint32_t column = 0; column < archetype->columns_.size(); column++) {
+                for (uint32_t row = 0; row < archetype->getRowCount(); row++) {
+                    if (archetype->game_objects_[row] != nullptr) {
+                        fn(archetype->getComponentBase(column, row));
+                    }
+                }
+            }
+        }
+    }
+
+    const std::vector<std::unique_ptr<Archetype>>& getArchetypes() const { return archetypes_; }
+
+private:
+    static bool findColumns(const Archetype* archetype, const ComponentTypeUUID* uuids, uint32_t* columns, size_t count);
+    Archetype* getArchetype(std::vector<ComponentTypeInfo> infos);
+    Archetype* getAddTarget(Archetype* archetype, const ComponentTypeInfo& info);
+    Archetype* getRemoveTarget(Archetype* archetype, ComponentTypeUUID uuid);
+    // 把一行移动到目标 archetype，目标中不存在的组件被析构
+    void moveRow(EntityLocation& location, Archetype* target);
+
+private:
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::map<std::vector<ComponentTypeUUID>, Archetype*> archetype_map_;
+};
+
+}  // namespace wen
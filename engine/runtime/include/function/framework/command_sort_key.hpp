@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace wen {
+
+// 记录命令时所在的上下文，EntityCommandBuffer 回放时按它排序，使结果与线程调度无关
+// 由 SystemScheduler 按系统设置高位，Scene::parallelEach 按块设置低位，其他情况为 0
+class CommandSortKey {
+public:
+    static uint64_t current() { return key_; }
+
+    // 系统序号加一，与系统之外记录的命令区分开
+    static uint64_t makeSystemKey(uint32_t run_index, uint32_t system_index) {
+        return (static_cast<uint64_t>(run_index & 0xffff) << 48) | (static_cast<uint64_t>((system_index + 1) & 0xffff) << 32);
+    }
+
+    // 在作用域内设置当前线程的排序键
+    class Scope {
+    public:
+        Scope(uint64_t key) : previous_(key_) { key_ = key; }
+        ~Scope() { key_ = previous_; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint64_t previous_;
+    };
+
+private:
+    static inline thread_local uint64_t key_ = 0;
+};
+
+}  // namespace wen
@@ -2,6 +2,7 @@
 
 #include "function/framework/rtti.hpp"
 #include "function/framework/uuid_manager.hpp"
+#include "core/serialize/serialize.hpp"
 
 namespace wen {
 
@@ -13,6 +14,11 @@ public:
     std::string getClassName() const override { return "Component"; }
     static std::string GetClassName() { return "Component"; }
 
+    Component() = default;
+    Component(const Component&) = default;
+    Component(Component&&) = default;
+    Component& operator=(const Component&) = default;
+    Component& operator=(Component&&) = default;
     virtual ~Component() = default;
 
     virtual void onCreate() {}
@@ -24,31 +30,19 @@ public:
     virtual void onDestroy() {}
 
 public:
-    uint32_t addMemberUpdateCallback(std::function<void(Component*)> callback) {
-        member_update_callbacks_.insert({current_member_update_callback_id_, std::move(callback)});
-        return current_member_update_callback_id_++;
-    }
-
-    void removeMemberUpdateCallback(uint32_t id) {
-        member_update_callbacks_.erase(id);
-    }
-
-    void triggerMemberUpdateCallbacks() {
-        for (const auto& [id, callback] : member_update_callbacks_) {
-            callback(this);
-        }
-    }
+    // 记录到所在 Scene 的 ComponentChangeTracker 中，在本帧的同步点统一处理
+    void markChanged();
 
     auto getComponentTypeUUID() const { return uuid_; }
 
+    auto getGameObject() const { return game_object_; }
+
 protected:
     ALLOW_PRIVATE_REFLECT()
 
     REFLECT_MEMBER()
     class GameObject* game_object_;
     ComponentTypeUUID uuid_;
-    uint32_t current_member_update_callback_id_ = 0;
-    std::map<uint32_t, std::function<void(Component*)>> member_update_callbacks_;
 };
 
 }  // namespace wen
\ No newline at end of file
@@ -12,12 +12,22 @@ public:
     std::string getClassName() const override { return "CameraComponent"; }
     static std::string GetClassName() { return "CameraComponent"; }
 
+    // 构造时向 camera_system 注册相机
+    static constexpr bool construct_on_main_thread = true;
+
     CameraComponent() {
         camera_id = global_context->camera_system->addCamera();
     }
 
+    // 组件在存储中移动时转移相机的所有权
+    CameraComponent(CameraComponent&& rhs) noexcept : Component(std::move(rhs)), camera_id(rhs.camera_id) {
+        rhs.camera_id = 0;
+    }
+
     ~CameraComponent() override {
-        global_context->camera_system->removeCamera(camera_id);
+        if (camera_id != 0) {
+            global_context->camera_system->removeCamera(camera_id);
+        }
         camera_id = 0;
     }
 
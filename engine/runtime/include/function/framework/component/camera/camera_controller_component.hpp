@@ -1,6 +1,7 @@
 #pragma once
 
-#include "function/framework/component/camera/camera_component.hpp"
+#include "function/framework/component/camera/orthographic_camera_component.hpp"
+#include "function/framework/component/camera/perspective_camera_component.hpp"
 #include "function/framework/component/transform/transform_component.hpp"
 #include "engine/global_context.hpp"
 #include <glm/ext/matrix_transform.hpp>
@@ -16,44 +17,18 @@ public:
     std::string getClassName() const override { return "CameraControllerComponent"; }
     static std::string GetClassName() { return "CameraControllerComponent"; }
 
-    ~CameraControllerComponent() override {
-        if (transform_component == nullptr) {
-            delete location;
-            delete yaw;
-            delete pitch;
-        }
-    }
-
     void onStart() override {
-        for (auto camera_component_class_name : {"CameraComponent", "OrthographicCameraComponent", "PerspectiveCameraComponent"}) {
-            camera_component = static_cast<CameraComponent*>(game_object_->queryComponent(camera_component_class_name));
-            if (camera_component != nullptr) {
-                break;
-            }
-        }
-        if (camera_component == nullptr) {
+        if (!bindComponents()) {
             WEN_CORE_ERROR("CameraControllerComponent requires a CameraComponent.");
             return;
         }
-
-        transform_component = game_object_->queryComponent<TransformComponent>();
-        if (transform_component == nullptr) {
-            location = new glm::vec3(0, 0, 0);
-            yaw = new float(0);
-            pitch = new float(0);
-        } else {
-            location = &transform_component->location;
-            yaw = &transform_component->rotation.y;
-            pitch = &transform_component->rotation.x;
-            transform_component->addMemberUpdateCallback([this](Component*) {
-                updateViewMatrix();
-            });
-        }
-
         updateViewMatrix();
     }
 
     void onTick(float dt) override {
+        if (!bindComponents()) {
+            return;
+        }
         auto mouse_delta = static_cast<double>(sensitivity * dt) * global_context->input_system->getMouseDelta();
         bool changed = false;
         if (global_context->input_system->isMousePressed(GLFW_MOUSE_BUTTON_LEFT)) {
@@ -91,15 +66,27 @@ public:
             changed = true;
         }
         if (changed) {
+            // 有 TransformComponent 时在同步点统一更新视图矩阵
+            if (transform_component != nullptr) {
+                transform_component->markDirty();
+            } else {
+                updateViewMatrix();
+            }
+        }
+    }
+
+    // 同一个 GameObject 的 TransformComponent 在本帧被修改过，由 SceneManager 在同步点调用
+    void onTransformChanged() {
+        if (bindComponents()) {
             updateViewMatrix();
         }
     }
 
-    CameraComponent* camera_component;
-    TransformComponent* transform_component;
-    glm::vec3* location;
-    float* yaw;
-    float* pitch;
+    CameraComponent* camera_component = nullptr;
+    TransformComponent* transform_component = nullptr;
+    glm::vec3* location = nullptr;
+    float* yaw = nullptr;
+    float* pitch = nullptr;
 
     REFLECT_MEMBER()
     float speed = 10;
@@ -108,10 +95,37 @@ public:
     float sensitivity = 10;
 
 private:
+    // 组件地址在 GameObject 增删组件后会改变，每次使用前重新绑定
+    bool bindComponents() {
+        camera_component = game_object_->queryComponent<CameraComponent>();
+        if (camera_component == nullptr) {
+            camera_component = game_object_->queryComponent<PerspectiveCameraComponent>();
+        }
+        if (camera_component == nullptr) {
+            camera_component = game_object_->queryComponent<OrthographicCameraComponent>();
+        }
+
+        transform_component = game_object_->queryComponent<TransformComponent>();
+        if (transform_component == nullptr) {
+            location = &fallback_location_;
+            yaw = &fallback_yaw_;
+            pitch = &fallback_pitch_;
+        } else {
+            location = &transform_component->location;
+            yaw = &transform_component->rotation.y;
+            pitch = &transform_component->rotation.x;
+        }
+        return camera_component != nullptr;
+    }
+
     void updateViewMatrix() {
         auto view_direction = glm::rotateY(glm::rotateX(glm::vec3(0, 0, 1), glm::radians(*pitch)), glm::radians(*yaw));
         global_context->camera_system->reportCameraViewMatrix(camera_component->camera_id, glm::lookAt(*location, *location + view_direction, {0, 1, 0}));
     }
+
+    glm::vec3 fallback_location_{0, 0, 0};
+    float fallback_yaw_ = 0;
+    float fallback_pitch_ = 0;
 };
 
 }  // namespace wen
\ No newline at end of file
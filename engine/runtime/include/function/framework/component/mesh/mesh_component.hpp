@@ -8,38 +8,71 @@ namespace wen {
 
 class MeshComponent : public Component {
     REFLECT_CLASS("MeshComponent")
+    SERIALIZABLE_CLASS
 
 public:
     std::string getClassName() const override { return "MeshComponent"; }
     static std::string GetClassName() { return "MeshComponent"; }
 
+    // 从场景快照加载时先默认构造再读入 mesh_id，网格需要按保存时的顺序加载
+    MeshComponent() = default;
     MeshComponent(MeshID mesh_id) : mesh_id(mesh_id) {}
-    MeshID mesh_id;
+
+    SERIALIZABLE_MEMBER
+    MeshID mesh_id = 0;
+
+    // 网格实例在池中的下标，世界矩阵或网格变化时由 SceneManager 写入
+    uint32_t mesh_instance_index = MeshInstancePool::invalid_index;
+    // 在 Scene 的 SpatialIndex 中的代理，世界矩阵或网格变化时由 SceneManager 更新
+    SpatialIndex::ProxyID spatial_proxy = SpatialIndex::invalid_proxy;
+
+    void setMeshID(MeshID value) {
+        mesh_id = value;
+        markChanged();
+    }
+
+    // 切换场景清空实例池后由 SceneManager 为新的场景重新创建
+    void createMeshInstance() {
+        auto mesh_instance_pool = global_context->render_system->getRenderData()->getMeshInstancePool();
+        // 没有 TransformComponent 时使用单位矩阵，之后添加的 TransformComponent 会在更新世界矩阵时同步过来
+        auto transform_component = game_object_->queryComponent<TransformComponent>();
+        mesh_instance_index = mesh_instance_pool->createMeshInstance({
+            .model = transform_component != nullptr ? transform_component->getWorldMatrix() : glm::mat4(1.0f),
+            .mesh_id = mesh_id
+        });
+    }
 
     void onCreate() override {
-        auto mesh_instance_pool = global_context->render_system->getRenderData()->getMeshInstancePool(); 
+        createMeshInstance();
+        spatial_proxy = game_object_->getScene()->getSpatialIndex().createProxy(getWorldBounds(), game_object_->getHandle());
+    }
+
+    void onDestroy() override {
+        // 退出时渲染器先于场景销毁，实例池已经不存在
+        auto* render_data = global_context->render_system->getRenderData();
+        if (render_data != nullptr && mesh_instance_index != MeshInstancePool::invalid_index) {
+            render_data->getMeshInstancePool()->destroyMeshInstance(mesh_instance_index);
+        }
+        mesh_instance_index = MeshInstancePool::invalid_index;
+        game_object_->getScene()->getSpatialIndex().destroyProxy(spatial_proxy);
+        spatial_proxy = SpatialIndex::invalid_proxy;
+    }
+
+    // 网格的包围盒变换到世界空间，再用包围球限制旋转后变大的部分
+    AABB getWorldBounds() const {
         auto transform_component = game_object_->queryComponent<TransformComponent>();
-        if (transform_component != nullptr) {
-            mesh_instance_pool->createMeshInstance({
-                .location = transform_component->location,
-                .rotation = transform_component->rotation,
-                .scale = transform_component->scale,
-                .mesh_id = mesh_id
-            }, game_object_->getUUID());
-            transform_component->addMemberUpdateCallback([transform_component, uuid = game_object_->getUUID()](Component* component) {
-                auto ptr = global_context->render_system->getRenderData()->getMeshInstancePool()->getMeshInstancePtr(uuid);
-                ptr->location = transform_component->location;
-                ptr->rotation = transform_component->rotation;
-                ptr->scale = transform_component->scale;
-            });
-        } else {
-            mesh_instance_pool->createMeshInstance({
-                .location = {0.0f, 0.0f, 0.0f},
-                .rotation = {0.0f, 0.0f, 0.0f},
-                .scale = {1.0f, 1.0f, 1.0f},
-                .mesh_id = mesh_id
-            }, game_object_->getUUID());
+        auto model = transform_component != nullptr ? transform_component->getWorldMatrix() : glm::mat4(1.0f);
+        glm::vec3 center = model[3];
+        auto bounds = global_context->asset_system->getMeshPool()->getMeshBounds(mesh_id);
+        if (bounds == nullptr) {
+            return {center, center};
         }
+        auto result = AABB{bounds->aabb_min, bounds->aabb_max}.transform(model);
+        float scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))});
+        auto extent = glm::vec3(bounds->radius * scale);
+        result.min = glm::max(result.min, center - extent);
+        result.max = glm::min(result.max, center + extent);
+        return result;
     }
 };
 
@@ -1,24 +1,88 @@
 #pragma once
 
-#include "function/framework/component.hpp"
+#include "function/framework/scene_manager.hpp"
 
 namespace wen {
 
 class TransformComponent : public Component {
     REFLECT_CLASS("TransformComponent")
+    SERIALIZABLE_CLASS
 
 public:
     std::string getClassName() const override { return "TransformComponent"; }
     static std::string GetClassName() { return "TransformComponent"; }
 
+    void onCreate() override {
+        node_ = getHierarchy().createNode(game_object_, location, rotation, scale);
+    }
+
+    void onDestroy() override {
+        getHierarchy().destroyNode(node_);
+        node_ = TransformHierarchy::invalid_node;
+    }
+
+    // 反射和反序列化写入之后同步到层次中，onCreate 之前还没有节点，onCreate 时按成员创建
+    void onPropertyChanged() override {
+        if (node_ != TransformHierarchy::invalid_node) {
+            markDirty();
+        }
+    }
+
+    // 直接修改 location、rotation、scale 之后需要调用，世界矩阵在下一次 Scene::updateTransforms 时更新
+    void markDirty() {
+        getHierarchy().setLocalTransform(node_, location, rotation, scale);
+        markChanged();
+    }
+
+    void setLocation(const glm::vec3& value) {
+        location = value;
+        markDirty();
+    }
+
+    void setRotation(const glm::vec3& value) {
+        rotation = value;
+        markDirty();
+    }
+
+    void setScale(const glm::vec3& value) {
+        scale = value;
+        markDirty();
+    }
+
+    // parent 为 nullptr 时成为根节点，局部变换保持不变，会形成环时返回 false
+    bool setParent(TransformComponent* parent) {
+        if (parent != nullptr && parent->game_object_->getScene() != game_object_->getScene()) {
+            WEN_CORE_ERROR("transform parent must be in the same scene.")
+            return false;
+        }
+        return getHierarchy().setParent(node_, parent == nullptr ? TransformHierarchy::invalid_node : parent->node_);
+    }
+
+    TransformComponent* getParent() const {
+        auto& hierarchy = getHierarchy();
+        auto parent = hierarchy.getParent(node_);
+        return parent == TransformHierarchy::invalid_node ? nullptr : hierarchy.getOwner(parent)->queryComponent<TransformComponent>();
+    }
+
+    const glm::mat4& getWorldMatrix() const { return getHierarchy().getWorldMatrix(node_); }
+
     REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
     glm::vec3 location{0, 0, 0};
 
+    // 欧拉角（度），按 Y、X、Z 的顺序旋转
     REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
     glm::vec3 rotation{0, 0, 0};
 
     REFLECT_MEMBER()
+    SERIALIZABLE_MEMBER
     glm::vec3 scale{1, 1, 1};
+
+private:
+    TransformHierarchy& getHierarchy() const { return game_object_->getScene()->getTransformHierarchy(); }
+
+    TransformHierarchy::NodeID node_ = TransformHierarchy::invalid_node;
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "function/framework/game_object.hpp"
+
+namespace wen {
+
+// 按组件类型记录本帧被修改过的 GameObject，每个 GameObject 在一帧内只记录一次
+// 修改时只有一次下标访问和一次 push_back，消费者在同步点一次性遍历变化列表
+class ComponentChangeTracker {
+public:
+    void markChanged(ComponentTypeUUID type, GameObjectHandle handle);
+
+    // 可能包含已经销毁的 GameObject，使用前需要通过 Scene::getGameObject 检查
+    const std::vector<GameObjectHandle>& getChanged(ComponentTypeUUID type) const {
+        return type < types_.size() ? types_[type].changed : empty_;
+    }
+
+    template <class C>
+    const std::vector<GameObjectHandle>& getChanged() const {
+        return getChanged(ComponentTypeUUIDSystem::get<C>());
+    }
+
+    // 同步点结束时调用，开销与变化数量成正比
+    void clear();
+
+private:
+    struct TypeChanges {
+        // GameObjectHandle::index -> 在 changed 中的位置 + 1，0 表示本帧未修改
+        std::vector<uint32_t> positions;
+        std::vector<GameObjectHandle> changed;
+    };
+
+    std::vector<TypeChanges> types_;
+    std::vector<ComponentTypeUUID> changed_types_;
+    std::vector<GameObjectHandle> empty_;
+};
+
+}  // namespace wen
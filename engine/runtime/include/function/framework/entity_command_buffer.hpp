@@ -0,0 +1,92 @@
+#pragma once
+
+#include "function/framework/game_object.hpp"
+#include "function/framework/command_sort_key.hpp"
+
+namespace wen {
+
+// 命令的目标，可以是已有的 GameObject，也可以是同一个缓冲中 spawn 出来的 GameObject
+struct CommandTarget {
+    static constexpr uint32_t invalid_spawn_index = std::numeric_limits<uint32_t>::max();
+
+    CommandTarget() = default;
+    CommandTarget(GameObjectHandle handle) : handle(handle) {}
+
+    GameObjectHandle handle;
+    uint32_t spawn_index = invalid_spawn_index;
+};
+
+// 构造函数访问全局系统的组件（例如 CameraComponent 向 camera_system 注册相机）声明 construct_on_main_thread，
+// 只能在主线程上构造，不能记录到后台线程的缓冲中
+template <class C>
+concept MainThreadComponent = requires { requires C::construct_on_main_thread; };
+
+// 记录 tick 中的结构修改，在同步点由 Scene::playbackCommandBuffers 统一回放
+// 每个线程使用自己的缓冲，记录时不加锁，通过 Scene::getCommandBuffer 获取
+class EntityCommandBuffer {
+    friend class Scene;
+
+public:
+    EntityCommandBuffer() = default;
+    ~EntityCommandBuffer();
+
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    // 返回的目标只能在这个缓冲中使用
+    CommandTarget spawn(const std::string& name);
+    // 回放时目标已经销毁则忽略
+    void destroy(CommandTarget target);
+
+    // 回放前组件归缓冲所有，回放时目标已经销毁则释放组件
+    template <class C>
+    void addComponent(CommandTarget target, C* component) {
+        if constexpr (MainThreadComponent<C>) {
+            WEN_CORE_ASSERT(!background_, "component must be constructed on the main thread")
+        }
+        record(CommandType::eAddComponent, target, ComponentTypeInfo::create<C>(ComponentTypeUUIDSystem::get<C>()), component);
+    }
+
+    template <class C>
+    void removeComponent(CommandTarget target) {
+        record(CommandType::eRemoveComponent, target, ComponentTypeInfo::create<C>(ComponentTypeUUIDSystem::get<C>()), nullptr);
+    }
+
+    // 在后台线程上记录的缓冲，不能添加 MainThreadComponent
+    void markBackground() { background_ = true; }
+
+    bool empty() const { return commands_.empty(); }
+    void clear();
+    void swap(EntityCommandBuffer& rhs) {
+        commands_.swap(rhs.commands_);
+        spawn_names_.swap(rhs.spawn_names_);
+    }
+
+private:
+    enum class CommandType {
+        eSpawn,
+        eDestroy,
+        eAddComponent,
+        eRemoveComponent,
+    };
+
+    struct Command {
+        CommandType type;
+        CommandTarget target;
+        uint64_t sort_key;
+        ComponentTypeInfo info;
+        Component* component;
+    };
+
+    void record(CommandType type, CommandTarget target, const ComponentTypeInfo& info, Component* component) {
+        commands_.push_back({type, target, CommandSortKey::current(), info, component});
+    }
+
+private:
+    std::vector<Command> commands_;
+    // spawn_index -> 名字
+    std::vector<std::string> spawn_names_;
+    bool background_ = false;
+};
+
+}  // namespace wen
@@ -1,12 +1,28 @@
 #pragma once
 
 #include "function/framework/component.hpp"
+#include "function/framework/archetype.hpp"
 
 namespace wen {
 
+class Scene;
+
+// 指向 Scene 中 GameObject 的句柄，对象销毁后 generation 改变，旧句柄随之失效
+struct GameObjectHandle {
+    static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = invalid_index;
+    uint32_t generation = 0;
+
+    bool operator==(const GameObjectHandle&) const = default;
+};
+
 class GameObject final {
+    friend class Scene;
+    friend class SceneSerializer;
+
 public:
-    GameObject(const std::string& name);
+    GameObject(const std::string& name, Scene& scene, GameObjectHandle handle);
     ~GameObject();
 
     void awake();
@@ -15,7 +31,13 @@ public:
     void tick(float dt);
     void postTick(float dt);
 
-    void addComponent(Component* component);
+    // 用 args 构造组件后移动到 Scene 的 ArchetypeStorage 中，返回存储中的地址，已有同类组件时返回 nullptr
+    // 本 GameObject 增删组件后，它的所有组件地址都会改变
+    template <class C, class... Args>
+    C* addComponent(Args&&... args) {
+        C component(std::forward<Args>(args)...);
+        return static_cast<C*>(insertComponent(&component, ComponentTypeInfo::create<C>(ComponentTypeUUIDSystem::get<C>())));
+    }
     void removeComponent(Component* component);
 
     Component* queryComponent(const std::string& class_name);
@@ -23,20 +45,61 @@ public:
 public:
     auto getUUID() const { return uuid_; }
 
+    auto getHandle() const { return handle_; }
+
+    auto getScene() const { return scene_; }
+
     auto getName() const { return name_; }
 
+    // 类型 uuid 已缓存，查询只需要一次下标访问
     template <class C>
     C* queryComponent() {
-        return static_cast<C*>(queryComponent(C::GetClassName()));
+        auto* archetype = location_.archetype;
+        if (archetype == nullptr) {
+            return nullptr;
+        }
+        uint32_t column = archetype->findColumn(ComponentTypeUUIDSystem::get<C>());
+        if (column == Archetype::invalid_column) {
+            return nullptr;
+        }
+        return static_cast<C*>(archetype->getComponent(column, location_.row));
     }
 
-    auto getComponents() { return components_; }
+    // 按组件类型 uuid 的顺序，不是加入的顺序，awake、start 和各个 tick 也按这个顺序调用
+    std::vector<Component*> getComponents() const;
+
+private:
+    // 检查组件能否加入
+    bool checkComponent(Component* component, const ComponentTypeInfo& info);
+    // 组件被移动到存储中，传入的对象仍归调用者所有
+    Component* insertComponent(Component* component, ComponentTypeInfo info);
+    // 一次加入多个组件，GameObject 只移动一次，全部加入后再依次调用 onCreate，传入的组件随后被释放
+    void insertComponents(const std::vector<std::pair<Component*, ComponentTypeInfo>>& components);
+    // 直接在存储中构造的组件，设置所属对象和类型，onCreate 由调用者负责
+    void bindComponent(Component* component, ComponentTypeUUID uuid, const ClassDescriptor* descriptor) {
+        component->uuid_ = uuid;
+        component->game_object_ = this;
+        component->setupRTTI(descriptor);
+    }
+
+    template <typename F>
+    void forEachComponent(F&& fn) const {
+        auto* archetype = location_.archetype;
+        if (archetype == nullptr) {
+            return;
+        }
+        for (uint32_t column = 0; column < archetype->getColumns().size(); column++) {
+            fn(archetype->getComponentBase(column, location_.row));
+        }
+    }
 
 private:
     GameObjectUUID uuid_;
+    GameObjectHandle handle_;
     std::string name_;
-    std::map<ComponentTypeUUID, Component*> component_map_;
-    std::list<Component*> components_;
+    Scene* scene_;
+    ArchetypeStorage* storage_;
+    EntityLocation location_;
 };
 
 }  // namespace wen
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "function/framework/game_object.hpp"
+
+namespace wen {
+
+// 按 handle 存放 GameObject 的 slot map，创建和销毁都是 O(1)
+// GameObject 按块原地构造，销毁其他对象不会改变它的地址
+class GameObjectPool {
+public:
+    static constexpr uint32_t chunk_slot_count = 1024;
+
+    GameObjectPool() = default;
+    ~GameObjectPool();
+
+    GameObjectPool(const GameObjectPool&) = delete;
+    GameObjectPool& operator=(const GameObjectPool&) = delete;
+
+    GameObject* create(const std::string& name, Scene& scene);
+    // 预先分配块，保证之后的 count 次 create 不再分配内存
+    void reserve(uint32_t count);
+    // handle 过期时返回 false
+    bool destroy(GameObjectHandle handle);
+    void clear();
+
+    // handle 过期时返回 nullptr
+    GameObject* get(GameObjectHandle handle) const {
+        if (handle.index >= slot_count_) {
+            return nullptr;
+        }
+        auto& slot = getSlot(handle.index);
+        if (!slot.alive || slot.generation != handle.generation) {
+            return nullptr;
+        }
+        return slot.get();
+    }
+    bool isValid(GameObjectHandle handle) const { return get(handle) != nullptr; }
+
+    uint32_t getAliveCount() const { return alive_count_; }
+
+    // 遍历过程中不能创建或销毁 GameObject
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (uint32_t index = 0; index < slot_count_; index++) {
+            auto& slot = getSlot(index);
+            if (slot.alive) {
+                fn(slot.get());
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        alignas(GameObject) std::byte storage[sizeof(GameObject)];
+        uint32_t generation = 1;
+        uint32_t next_free = GameObjectHandle::invalid_index;
+        bool alive = false;
+
+        GameObject* get() const { return std::launder(reinterpret_cast<GameObject*>(const_cast<std::byte*>(storage))); }
+    };
+
+    Slot& getSlot(uint32_t index) const { return chunks_[index / chunk_slot_count][index % chunk_slot_count]; }
+
+private:
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    uint32_t slot_count_ = 0;
+    uint32_t free_head_ = GameObjectHandle::invalid_index;
+    uint32_t alive_count_ = 0;
+};
+
+}  // namespace wen
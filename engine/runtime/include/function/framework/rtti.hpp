@@ -8,9 +8,15 @@ namespace wen {
 class RTTI {
 public:
     void setupRTTI();
+    // 同一类型的大量对象只查找一次描述
+    void setupRTTI(const ClassDescriptor* descriptor) { descriptor_ = descriptor; }
     virtual std::string getClassName() const { return ""; }
     static std::string GetClassName() { return ""; }
 
+    // 通过反射或者反序列化写入成员之后调用，用于同步依赖成员的状态
+    // 通过 getValueRef 直接修改成员时需要自己调用
+    virtual void onPropertyChanged() {}
+
 public:
     template <typename T>
     const T& getValueConst(const std::string& name) const {
@@ -25,6 +31,13 @@ public:
     template <typename T>
     void setValue(const std::string& name, T&& value) {
         descriptor_->getMember(name).setValueByPtr(this, std::forward<T>(value));
+        onPropertyChanged();
+    }
+
+    // 按字节写入，value 指向一个同类型的对象
+    void copyValueFrom(const Member& member, const void* value) {
+        member.copyValueFrom(static_cast<void*>(this), value);
+        onPropertyChanged();
     }
 
     template <typename... Args>
@@ -45,6 +58,56 @@ public:
         return descriptor_->getFunction(name);
     }
 
+public:
+    // 热路径上先解析句柄并缓存，之后每次访问没有查找
+    MemberHandle findMember(NameID id) const { return descriptor_->findMember(id); }
+    FunctionHandle findFunction(NameID id) const { return descriptor_->findFunction(id); }
+
+    template <typename T>
+    const T& getValueConst(MemberHandle handle) const {
+        return handle.member->getValueConstByPtr<T>(this);
+    }
+
+    template <typename T>
+    T& getValueRef(MemberHandle handle) {
+        return handle.member->getValueReferenceByPtr<T>(this);
+    }
+
+    // 类型已经在解析时检查过
+    template <typename T>
+    const T& getValueConst(TypedMember<T> member) const {
+        return member.get(static_cast<const void*>(this));
+    }
+
+    template <typename T>
+    T& getValueRef(TypedMember<T> member) {
+        return member.get(static_cast<void*>(this));
+    }
+
+    template <typename T>
+    void setValue(MemberHandle handle, T&& value) {
+        handle.member->setValueByPtr(this, std::forward<T>(value));
+        onPropertyChanged();
+    }
+
+    template <typename... Args>
+    Any invoke(FunctionHandle handle, Args&&... args) {
+        return handle.function->invokeByPtr<Args...>(this, std::forward<Args>(args)...);
+    }
+
+    template <typename R, typename... Args>
+    R invokeEx(FunctionHandle handle, Args&&... args) {
+        return handle.function->invokeByPtrEx<R, Args...>(this, std::forward<Args>(args)...);
+    }
+
+    // 签名已经在解析时检查过，参数和返回值都在栈上
+    template <typename R, typename... Args, typename... CallArgs>
+    R invoke(const TypedFunction<R(Args...)>& function, CallArgs&&... args) {
+        return function.invoke(static_cast<void*>(this), std::forward<CallArgs>(args)...);
+    }
+
+    const ClassDescriptor* getDescriptor() const { return descriptor_; }
+
 private:
     const ClassDescriptor* descriptor_;
 };
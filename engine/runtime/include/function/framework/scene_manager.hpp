@@ -1,27 +1,111 @@
 #pragma once
 
-#include "function/framework/game_object.hpp"
+#include "function/framework/game_object_pool.hpp"
+#include "function/framework/transform_hierarchy.hpp"
+#include "function/framework/component_change_tracker.hpp"
+#include "function/framework/system.hpp"
+#include "function/framework/entity_command_buffer.hpp"
+#include "function/framework/spatial_index.hpp"
+#include "function/framework/world_partition.hpp"
 
 namespace wen {
 
 class Scene final {
 public:
-    Scene(const std::string& name) : name_(name) {}
+    Scene(const std::string& name);
     ~Scene();
 
     void awake();
     void start();
-    void fixedTick();
+    // 场景开始之后加入的对象，所有组件 onAwake 之后再 onStart，跳过已经销毁的对象
+    void startGameObjects(const std::vector<GameObjectHandle>& handles);
+    // 依次运行对应阶段的系统，组件的 onFixedTick、onTick、onPostTick 由最先注册的 LegacyComponentSystem 调用
+    void fixedTick(float dt);
     void tick(float dt);
     void postTick(float dt);
 
+    // 非独占系统在工作线程上运行，不能直接增删 GameObject 和组件，也不能调用 markChanged
+    // 结构修改通过 getCommandBuffer 记录，在同步点回放
+    template <class S, typename... Args>
+    S* addSystem(SystemPhase phase, Args&&... args) {
+        return static_cast<S*>(scheduler_.addSystem(phase, std::make_unique<S>(std::forward<Args>(args)...)));
+    }
+    void removeSystem(System* system) { scheduler_.removeSystem(system); }
+
     GameObject* createGameObject(const std::string& name);
+    // 保证之后的 count 次 createGameObject 不再分配内存
+    void reserveGameObjects(uint32_t count) { game_objects_.reserve(count); }
+    // 立即销毁，不能在遍历组件的过程中调用
     void removeGameObject(GameObject* game_object);
+    // 延迟到 flushDestroyedGameObjects 时销毁，可以在 tick 中调用，重复销毁或 handle 过期时忽略
+    void destroyGameObject(GameObjectHandle handle);
+    void flushDestroyedGameObjects();
+    // 当前线程的命令缓冲，只能在主线程和 JobSystem 的工作线程上使用
+    EntityCommandBuffer& getCommandBuffer() {
+        auto worker = JobSystem::getCurrentWorkerIndex();
+        return *command_buffers_[worker < 0 ? command_buffers_.size() - 1 : static_cast<size_t>(worker)];
+    }
+    // 合并所有线程的命令，按排序键回放，结果与线程调度无关
+    void playbackCommandBuffers();
+    // 回放一个独立的缓冲，例如在后台线程上记录的单元格，spawned_game_objects 按 spawn 的顺序追加创建的对象
+    void playbackCommandBuffer(EntityCommandBuffer& buffer, std::vector<GameObjectHandle>* spawned_game_objects = nullptr);
+    // 重新计算本帧修改过的 TransformComponent 及其子节点的世界矩阵
+    void updateTransforms();
+
+    // handle 过期时返回 nullptr
+    GameObject* getGameObject(GameObjectHandle handle) const { return game_objects_.get(handle); }
+    uint32_t getGameObjectCount() const { return game_objects_.getAliveCount(); }
+    // 遍历过程中不能创建或销毁 GameObject
+    template <typename F>
+    void forEachGameObject(F&& fn) const {
+        game_objects_.forEach(std::forward<F>(fn));
+    }
+
+    const std::string& getName() const { return name_; }
+    // 保存所有注册了序列化的组件和变换层次，其他组件被忽略
+    // compress 为 true 时按块压缩
+    bool save(const std::string& path, bool compress = false);
+
+    // 遍历同时拥有 Cs... 组件的 GameObject，fn(Cs&...) 或 fn(GameObject*, Cs&...)
+    // 遍历过程中不能增删正在访问的 GameObject 的组件
+    template <class... Cs, typename F>
+    void each(F&& fn) {
+        storage_.each<Cs...>(std::forward<F>(fn));
+    }
+
+    // 按块并行遍历，fn 会在多个线程上同时调用
+    template <class... Cs, typename F>
+    void parallelEach(F&& fn) {
+        storage_.parallelEach<Cs...>(getJobSystem(), std::forward<F>(fn));
+    }
+
+    auto& getStorage() { return storage_; }
+    auto& getTransformHierarchy() { return transform_hierarchy_; }
+    auto& getChangeTracker() { return change_tracker_; }
+    // 开启后由 SceneManager 每帧按相机位置流式加载单元格，重复调用时替换原来的划分，已经提交的对象留在场景中
+    WorldPartition* enableWorldPartition(const WorldPartition::Settings& settings = {});
+    // 没有开启时返回 nullptr，整个场景常驻内存
+    WorldPartition* getWorldPartition() const { return world_partition_.get(); }
+    // 带 MeshComponent 的对象按世界包围盒建立的索引，每帧在 tick 之后的同步点更新
+    auto& getSpatialIndex() { return spatial_index_; }
+
+private:
+    static JobSystem& getJobSystem();
+    void playback(EntityCommandBuffer* buffers, uint32_t buffer_count, std::vector<GameObjectHandle>* spawned_game_objects);
 
 private:
     std::string name_;
-    std::map<uint64_t, GameObject*> game_object_map_;
-    std::list<GameObject*> game_objects_;
+    SystemScheduler scheduler_;
+    ArchetypeStorage storage_;
+    TransformHierarchy transform_hierarchy_;
+    ComponentChangeTracker change_tracker_;
+    SpatialIndex spatial_index_;
+    // 析构时先于 storage_ 和 transform_hierarchy_ 释放 GameObject
+    GameObjectPool game_objects_;
+    std::vector<GameObjectHandle> pending_destroy_;
+    // 每个工作线程一个，最后一个属于主线程
+    std::vector<std::unique_ptr<EntityCommandBuffer>> command_buffers_;
+    std::unique_ptr<WorldPartition> world_partition_;
 };
 
 class SceneManager final {
@@ -32,12 +116,22 @@ class SceneManager final {
 public:
     Scene* createScene(const std::string& name);
     void loadScene(const std::string& name);
+    // 按文件中的名字创建场景并读入快照，之后通过 loadScene 切换，失败时返回 nullptr
+    Scene* load(const std::string& path);
 
     void start();
-    void fixedTick();
+    void fixedTick(float dt);
     void tick(float dt);
     void swap();
 
+private:
+    // 每帧 tick 之后的同步点，按变化列表一次性处理本帧的修改
+    void syncMeshInstances();
+    void syncCameraControllers();
+    void syncSpatialIndex();
+    // 流式加载的焦点，使用视口相机的位置
+    glm::vec3 getStreamingFocus() const;
+
 private:
     std::map<std::string, Scene*> scenes_;
     Scene* active_scene_;
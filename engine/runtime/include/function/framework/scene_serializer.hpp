@@ -0,0 +1,84 @@
+#pragma once
+
+#include "function/framework/component.hpp"
+#include "function/framework/archetype.hpp"
+#include "core/serialize/stream.hpp"
+
+namespace wen {
+
+class Scene;
+
+// 一种可序列化组件的读写函数，由解析器生成的 Parser() 为每个 SERIALIZABLE_CLASS 组件注册
+// 组件含有虚表，不能整体复制，packed_size 不为 0 时所有序列化成员都可以平凡复制，按成员写入连续的数组
+struct ComponentSerializer {
+    std::string class_name;
+    ComponentTypeInfo info;
+    void (*construct)(void* dst);
+    void (*serialize)(SerializeStream& stream, const void* component);
+    void (*deserialize)(DeserializeStream& stream, void* component);
+    uint32_t packed_size = 0;
+    void (*pack)(uint8_t* dst, const void* component) = nullptr;
+    void (*unpack)(const uint8_t* src, void* component) = nullptr;
+};
+
+// 场景快照的二进制格式：组件类型表、对象名字、按 archetype 分组的每种组件的连续数组和变换层次
+// 加载时一次分配所有对象，每组对象直接在最终的 archetype 中原地构造组件
+class SceneSerializer final {
+    friend class Singleton<SceneSerializer>;
+    SceneSerializer();
+    ~SceneSerializer();
+
+public:
+    static constexpr uint32_t magic = 0x4e435357;  // "WSCN"
+    static constexpr uint32_t version = 2;
+
+    // 不是 Component 或者不能默认构造的类型直接忽略
+    template <class C>
+    void registerComponent() {
+        if constexpr (std::is_base_of_v<Component, C> && std::is_default_constructible_v<C>) {
+            auto uuid = ComponentTypeUUIDSystem::get<C>();
+            ComponentSerializer serializer{
+                .class_name = C::GetClassName(),
+                .info = ComponentTypeInfo::create<C>(uuid),
+                .construct = [](void* dst) { new (dst) C(); },
+                .serialize = [](SerializeStream& stream, const void* component) { stream << *static_cast<const C*>(component); },
+                .deserialize = [](DeserializeStream& stream, void* component) { stream >> *static_cast<C*>(component); },
+            };
+            if constexpr (requires { SerializeTraits<C>::packable; }) {
+                if constexpr (SerializeTraits<C>::packable) {
+                    serializer.packed_size = static_cast<uint32_t>(SerializeTraits<C>::packed_size);
+                    serializer.pack = [](uint8_t* dst, const void* component) { SerializeTraits<C>::pack(dst, *static_cast<const C*>(component)); };
+                    serializer.unpack = [](const uint8_t* src, void* component) { SerializeTraits<C>::unpack(src, *static_cast<C*>(component)); };
+                }
+            }
+            addSerializer(std::move(serializer));
+        }
+    }
+
+    // 没有注册的组件类型不会被保存
+    const ComponentSerializer* find(ComponentTypeUUID uuid) const {
+        return uuid < serializers_.size() && serializers_[uuid].has_value() ? &*serializers_[uuid] : nullptr;
+    }
+    const ComponentSerializer* find(const std::string& class_name) const;
+
+    // compress 为 true 时按块压缩，加载时根据文件头自动解压
+    bool save(Scene& scene, const std::string& path, bool compress = false) const;
+    // 读入到一个空的场景中，组件 onCreate 之后恢复变换层次，onAwake 和 onStart 在场景开始时调用
+    bool load(Scene& scene, const std::string& path) const;
+    // stream 已经读过文件头
+    bool load(Scene& scene, DeserializeStream& stream) const;
+
+    // 读出场景名字，文件格式或版本不符时返回 false
+    static bool readHeader(DeserializeStream& stream, std::string& name);
+    // 打开场景文件交给 fn 读取，压缩的文件边读边解压，文件打不开或者 fn 返回 false 时返回 false
+    static bool open(const std::string& path, const std::function<bool(DeserializeStream&)>& fn);
+
+private:
+    void addSerializer(ComponentSerializer&& serializer);
+
+private:
+    // 按组件类型 uuid 索引
+    std::vector<std::optional<ComponentSerializer>> serializers_;
+};
+
+}  // namespace wen
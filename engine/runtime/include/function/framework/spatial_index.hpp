@@ -0,0 +1,218 @@
+#pragma once
+
+#include "function/framework/game_object.hpp"
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace wen {
+
+struct AABB {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+
+    bool contains(const AABB& rhs) const { return glm::all(glm::lessThanEqual(min, rhs.min)) && glm::all(glm::greaterThanEqual(max, rhs.max)); }
+    bool overlaps(const AABB& rhs) const { return glm::all(glm::lessThanEqual(min, rhs.max)) && glm::all(glm::greaterThanEqual(max, rhs.min)); }
+    // 表面积的一半，只用于比较插入代价
+    float getHalfArea() const {
+        auto extent = max - min;
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+    // 点到包围盒的距离的平方，点在内部时为 0
+    float distance2(const glm::vec3& point) const {
+        auto delta = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+        return glm::dot(delta, delta);
+    }
+
+    static AABB merge(const AABB& lhs, const AABB& rhs) { return {glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max)}; }
+    // 变换后八个角点的轴对齐包围盒
+    AABB transform(const glm::mat4& matrix) const;
+};
+
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+
+    // 与包围盒相交时返回 true，t 为进入包围盒的距离，起点在内部时为 0
+    bool intersect(const AABB& aabb, float max_distance, float& t) const;
+};
+
+// 六个平面的法线指向视锥内部
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // 从 projection * view 中提取，近平面按 [-1, 1] 的深度范围计算，对 [0, 1] 也是保守的
+    static Frustum fromMatrix(const glm::mat4& view_projection);
+    // 保守测试，视锥角附近的包围盒可能误判为相交
+    bool intersects(const AABB& aabb) const;
+};
+
+// 场景对象的动态包围盒层次（BVH），叶子使用向外扩大的包围盒
+// 物体在扩大的范围内移动时只更新精确包围盒，超出后才从树中移除并重新插入
+// 修改只能在主线程的同步点进行，查询是只读的，可以在多个工作线程上同时调用
+class SpatialIndex {
+public:
+    using ProxyID = uint32_t;
+    static constexpr ProxyID invalid_proxy = std::numeric_limits<ProxyID>::max();
+    // 叶子包围盒四周扩大的距离
+    static constexpr float fat_margin = 0.1f;
+
+    struct NearestResult {
+        GameObjectHandle handle;
+        float distance;
+    };
+
+    ProxyID createProxy(const AABB& bounds, GameObjectHandle handle);
+    void destroyProxy(ProxyID proxy);
+    // 只记录新的包围盒，在 refit 时统一调整树的结构
+    void moveProxy(ProxyID proxy, const AABB& bounds);
+    // 处理上一次 refit 之后所有的 moveProxy
+    void refit();
+    void clear();
+
+    const AABB& getBounds(ProxyID proxy) const { return bounds_[proxy]; }
+    GameObjectHandle getHandle(ProxyID proxy) const { return nodes_[proxy].handle; }
+    uint32_t getProxyCount() const { return proxy_count_; }
+    // 空树为 0，只有一个叶子时为 1
+    uint32_t getHeight() const { return root_ == invalid_node ? 0 : static_cast<uint32_t>(nodes_[root_].height) + 1; }
+
+    // fn(GameObjectHandle)，以下查询按精确包围盒测试
+    template <typename F>
+    void queryAABB(const AABB& aabb, F&& fn) const {
+        traverse([&](const AABB& bounds) { return bounds.overlaps(aabb); }, fn);
+    }
+
+    template <typename F>
+    void queryFrustum(const Frustum& frustum, F&& fn) const {
+        traverse([&](const AABB& bounds) { return frustum.intersects(bounds); }, fn);
+    }
+
+    template <typename F>
+    void querySphere(const glm::vec3& center, float radius, F&& fn) const {
+        float radius2 = radius * radius;
+        traverse([&](const AABB& bounds) { return bounds.distance2(center) <= radius2; }, fn);
+    }
+
+    // fn(GameObjectHandle, float t) 返回新的最大距离，返回 t 只保留更近的命中，返回 0 结束查询
+    // 命中不按距离排序
+    template <typename F>
+    void raycast(const Ray& ray, float max_distance, F&& fn) const {
+        if (root_ == invalid_node) {
+            return;
+        }
+        NodeStack stack;
+        stack.push(root_);
+        while (!stack.empty()) {
+            auto index = stack.pop();
+            const auto& node = nodes_[index];
+            float t = 0.0f;
+            if (!ray.intersect(node.bounds, max_distance, t)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                if (ray.intersect(bounds_[index], max_distance, t)) {
+                    max_distance = std::min(max_distance, static_cast<float>(fn(node.handle, t)));
+                    if (max_distance <= 0.0f) {
+                        return;
+                    }
+                }
+                continue;
+            }
+            stack.push(node.children[0]);
+            stack.push(node.children[1]);
+        }
+    }
+
+    // 精确包围盒距离 point 最近的 k 个对象，由近到远追加到 results
+    void queryNearest(const glm::vec3& point, uint32_t k, std::vector<NearestResult>& results) const;
+
+private:
+    static constexpr uint32_t invalid_node = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        // 叶子为扩大后的包围盒，内部节点为两个子节点的并
+        AABB bounds;
+        // 空闲节点中保存下一个空闲节点
+        uint32_t parent = invalid_node;
+        uint32_t children[2] = {invalid_node, invalid_node};
+        // 叶子为 0，空闲节点为 -1
+        int32_t height = -1;
+        GameObjectHandle handle;
+
+        bool isLeaf() const { return children[0] == invalid_node; }
+    };
+
+    // 遍历用的栈，深度不超过 inline_capacity 时不分配内存
+    class NodeStack {
+    public:
+        void push(uint32_t index) {
+            if (size_ < inline_capacity) {
+                inline_[size_] = index;
+            } else {
+                overflow_.push_back(index);
+            }
+            size_++;
+        }
+        uint32_t pop() {
+            size_--;
+            if (size_ < inline_capacity) {
+                return inline_[size_];
+            }
+            auto index = overflow_.back();
+            overflow_.pop_back();
+            return index;
+        }
+        bool empty() const { return size_ == 0; }
+
+    private:
+        static constexpr uint32_t inline_capacity = 64;
+        uint32_t inline_[inline_capacity];
+        std::vector<uint32_t> overflow_;
+        uint32_t size_ = 0;
+    };
+
+    template <typename T, typename F>
+    void traverse(T&& test, F& fn) const {
+        if (root_ == invalid_node) {
+            return;
+        }
+        NodeStack stack;
+        stack.push(root_);
+        while (!stack.empty()) {
+            auto index = stack.pop();
+            const auto& node = nodes_[index];
+            if (!test(node.bounds)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                if (test(bounds_[index])) {
+                    fn(node.handle);
+                }
+                continue;
+            }
+            stack.push(node.children[0]);
+            stack.push(node.children[1]);
+        }
+    }
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t index);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    // 从 index 向上重新计算包围盒和高度，并做旋转保持平衡
+    void fixUpwards(uint32_t index);
+    uint32_t balance(uint32_t index);
+    static AABB fatten(const AABB& bounds) { return {bounds.min - glm::vec3(fat_margin), bounds.max + glm::vec3(fat_margin)}; }
+
+private:
+    std::vector<Node> nodes_;
+    // 按节点下标索引，叶子的精确包围盒
+    std::vector<AABB> bounds_;
+    std::vector<uint8_t> moved_;
+    std::vector<ProxyID> moved_proxies_;
+    uint32_t root_ = invalid_node;
+    uint32_t free_head_ = invalid_node;
+    uint32_t proxy_count_ = 0;
+};
+
+}  // namespace wen
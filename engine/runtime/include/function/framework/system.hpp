@@ -0,0 +1,114 @@
+#pragma once
+
+#include "function/framework/uuid_manager.hpp"
+#include "function/framework/command_sort_key.hpp"
+
+namespace wen {
+
+class Scene;
+
+enum class SystemPhase {
+    eFixedTick,
+    eTick,
+    ePostTick,
+};
+
+// 系统读写的组件类型，调度器据此判断两个系统能否并行
+class SystemAccess {
+public:
+    template <class... Cs>
+    SystemAccess& read() {
+        (reads_.push_back(ComponentTypeUUIDSystem::get<Cs>()), ...);
+        return *this;
+    }
+
+    template <class... Cs>
+    SystemAccess& write() {
+        (writes_.push_back(ComponentTypeUUIDSystem::get<Cs>()), ...);
+        return *this;
+    }
+
+    // 访问未声明的数据或者必须在主线程运行，与其他所有系统串行
+    SystemAccess& exclusive() {
+        exclusive_ = true;
+        return *this;
+    }
+
+    bool isExclusive() const { return exclusive_; }
+    // 任意一方写了另一方读写的类型时冲突
+    bool conflicts(const SystemAccess& rhs) const;
+
+private:
+    std::vector<ComponentTypeUUID> reads_;
+    std::vector<ComponentTypeUUID> writes_;
+    bool exclusive_ = false;
+};
+
+// 系统在注册时声明访问的组件类型，每帧在对应阶段运行一次
+// 非独占的系统在工作线程上运行，可以与不冲突的系统同时运行
+class System {
+    friend class SystemScheduler;
+
+public:
+    System(const std::string& name) : name_(name) {}
+    virtual ~System() = default;
+
+    virtual void setupAccess(SystemAccess& access) = 0;
+    virtual void run(Scene& scene, float dt) = 0;
+
+    const std::string& getName() const { return name_; }
+    // 注册时驻留的名字，性能分析器只保存指针，系统销毁后仍然有效
+    const char* getProfileName() const { return profile_name_; }
+
+private:
+    std::string name_;
+    const char* profile_name_ = nullptr;
+};
+
+// 在主线程上按原来的顺序调用所有组件的 onFixedTick、onTick 或 onPostTick
+class LegacyComponentSystem final : public System {
+public:
+    LegacyComponentSystem(SystemPhase phase);
+
+    void setupAccess(SystemAccess& access) override { access.exclusive(); }
+    void run(Scene& scene, float dt) override;
+
+private:
+    SystemPhase phase_;
+};
+
+// 每个 Scene 一份，按阶段保存系统，运行时根据声明的访问构建依赖图
+// 冲突的系统按注册顺序执行，独占系统把同一阶段分成前后两段
+class SystemScheduler {
+public:
+    System* addSystem(SystemPhase phase, std::unique_ptr<System> system);
+    void removeSystem(System* system);
+
+    void run(SystemPhase phase, Scene& scene, float dt);
+    // 命令缓冲回放之后调用，排序键中的运行序号重新开始
+    void resetRunCount() { run_count_ = 0; }
+
+private:
+    struct SystemNode {
+        std::unique_ptr<System> system;
+        SystemAccess access;
+    };
+
+    struct PhaseGraph {
+        std::vector<SystemNode> nodes;
+        // 每个节点之后必须等待它完成的节点
+        std::vector<std::vector<uint32_t>> successors;
+        std::vector<uint32_t> predecessor_counts;
+        bool dirty = true;
+    };
+
+    static void buildGraph(PhaseGraph& graph);
+    // 并行运行 [begin, end) 中的非独占系统
+    static void runParallel(PhaseGraph& graph, uint32_t begin, uint32_t end, uint32_t run_index, Scene& scene, float dt);
+
+private:
+    std::array<PhaseGraph, 3> phases_;
+    uint32_t run_count_ = 0;
+};
+
+}  // namespace wen
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace wen {
+
+class GameObject;
+
+// 场景中所有 TransformComponent 的父子关系和世界矩阵
+// 数据按深度排序存放在连续的数组中，父节点总在子节点之前
+// 修改只标记脏节点，每帧 update 时一次性沿层级向下传播并只重新计算脏的子树
+class TransformHierarchy {
+public:
+    using NodeID = uint32_t;
+    static constexpr NodeID invalid_node = std::numeric_limits<NodeID>::max();
+
+    NodeID createNode(GameObject* owner, const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale);
+    // 子节点变为根节点，保持原来的局部变换
+    void destroyNode(NodeID node);
+    // 保证之后的 count 次 createNode 不再分配内存
+    void reserve(uint32_t count);
+
+    // parent 为 invalid_node 时成为根节点，会形成环时返回 false
+    bool setParent(NodeID node, NodeID parent);
+    NodeID getParent(NodeID node) const { return nodes_[node].parent; }
+    GameObject* getOwner(NodeID node) const { return nodes_[node].owner; }
+
+    // rotation 为欧拉角（度），按 Y、X、Z 的顺序旋转
+    void setLocalTransform(NodeID node, const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale);
+    // 上一次 update 的结果
+    const glm::mat4& getWorldMatrix(NodeID node) const { return world_matrices_[nodes_[node].position]; }
+
+    // 重新计算所有脏节点的世界矩阵
+    void update();
+    // 上一次 update 中世界矩阵发生变化的 GameObject
+    const std::vector<GameObject*>& getChangedGameObjects() const { return changed_game_objects_; }
+
+    uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes_.size() - free_nodes_.size()); }
+
+    static glm::mat4 composeMatrix(const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale);
+
+private:
+    struct Node {
+        GameObject* owner = nullptr;
+        NodeID parent = invalid_node;
+        uint32_t position = 0;
+        uint32_t child_count = 0;
+    };
+
+    static constexpr uint32_t invalid_position = std::numeric_limits<uint32_t>::max();
+
+    void markDirty(uint32_t position);
+    // 按深度重新排列，移除已销毁节点留下的空位
+    void rebuild();
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<NodeID> free_nodes_;
+
+    // 以下数组按 position 索引，rebuild 之后按深度排序
+    std::vector<NodeID> node_ids_;  // 已销毁为 invalid_node
+    std::vector<uint32_t> parents_;
+    std::vector<glm::vec3> locations_;
+    std::vector<glm::vec3> rotations_;
+    std::vector<glm::vec3> scales_;
+    std::vector<glm::mat4> world_matrices_;
+    std::vector<uint8_t> dirty_;
+    std::vector<uint32_t> depth_offsets_;  // 每一层的起始位置，最后一个元素之后是 rebuild 之后新建的根节点
+
+    bool order_dirty_ = false;
+    bool has_dirty_ = false;
+    uint32_t hole_count_ = 0;
+    std::vector<GameObject*> changed_game_objects_;
+};
+
+}  // namespace wen
@@ -19,6 +19,8 @@ private:
     GameObjectUUID current_uuid_;
 };
 
+// 组件类型的 uuid 从 1 开始连续分配，可以直接作为数组下标
+// 名字到 uuid 的映射在整个进程内有效，每种类型第一次使用时注册并缓存在静态变量中
 class ComponentTypeUUIDSystem final {
     friend class Singleton<ComponentTypeUUIDSystem>;
     ComponentTypeUUIDSystem();
@@ -27,9 +29,14 @@ class ComponentTypeUUIDSystem final {
 public:
     ComponentTypeUUID get(const std::string& class_name);
 
+    template <class C>
+    static ComponentTypeUUID get() {
+        static const ComponentTypeUUID uuid = registerClass(C::GetClassName());
+        return uuid;
+    }
+
 private:
-    std::map<std::string, ComponentTypeUUID> uuid_map_;
-    ComponentTypeUUID current_uuid_;
+    static ComponentTypeUUID registerClass(const std::string& class_name);
 };
 
 }  // namespace wen
\ No newline at end of file
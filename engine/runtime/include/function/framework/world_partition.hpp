@@ -0,0 +1,106 @@
+#pragma once
+
+#include "function/framework/entity_command_buffer.hpp"
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace wen {
+
+class Scene;
+
+// 单元格在 xz 平面上的坐标，覆盖 [x, x + 1) * cell_size 和 [z, z + 1) * cell_size
+struct CellCoord {
+    int32_t x = 0;
+    int32_t z = 0;
+
+    bool operator==(const CellCoord& rhs) const = default;
+};
+
+struct CellCoordHash {
+    size_t operator()(const CellCoord& coord) const { return std::hash<uint64_t>()((static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.z)); }
+};
+
+// 把场景划分为 xz 平面上的单元格，按与焦点的距离流式加载和卸载
+// 单元格的内容在后台线程上读取和构造，记录到 EntityCommandBuffer 中，再在主线程上按时间预算分批提交
+class WorldPartition {
+public:
+    // 在后台线程上调用，只能向 buffer 中记录命令，不能访问 Scene
+    // 组件也在后台线程上构造，构造函数访问全局系统的 MainThreadComponent 不能在这里添加
+    using CellLoader = std::function<void(EntityCommandBuffer& buffer)>;
+
+    struct Settings {
+        float cell_size = 64.0f;
+        float load_distance = 256.0f;
+        // 大于 load_distance，避免焦点在边界附近时反复加载和卸载
+        float unload_distance = 320.0f;
+        // 每帧提交单元格的时间预算，至少提交一个单元格
+        float commit_budget_ms = 2.0f;
+        // 同时在后台加载的单元格数量
+        uint32_t max_loading_cells = 4;
+    };
+
+    WorldPartition(Scene& scene, const Settings& settings);
+    // 等待正在加载的单元格，已经提交的对象留在场景中
+    ~WorldPartition();
+
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+
+    void addCell(CellCoord coord, CellLoader loader);
+    CellCoord getCellCoord(const glm::vec3& position) const;
+
+    // 主线程每帧调用一次：卸载超出范围的单元格，开始加载进入范围的单元格，提交已经加载完成的单元格
+    void update(const glm::vec3& focus);
+
+    bool isCellResident(CellCoord coord) const;
+    uint32_t getResidentCellCount() const { return resident_cell_count_; }
+    uint32_t getLoadingCellCount() const { return loading_cell_count_; }
+
+private:
+    enum class CellState {
+        eUnloaded,
+        eLoading,
+        // 后台加载完成，等待提交
+        eReady,
+        eResident,
+    };
+
+    struct Cell {
+        CellCoord coord;
+        CellLoader loader;
+        // 以下只在主线程上访问
+        CellState state = CellState::eUnloaded;
+        // 加载期间离开范围，加载完成后直接丢弃
+        bool cancelled = false;
+        float distance = 0.0f;
+        std::vector<GameObjectHandle> game_objects;
+        // 加载期间只由后台线程访问，loaded 之后归主线程
+        EntityCommandBuffer buffer;
+        std::atomic<bool> loaded = false;
+    };
+
+    float getDistance(const Cell& cell, const glm::vec3& focus) const;
+    void unloadCell(Cell& cell);
+    void commitCell(Cell& cell);
+    void loaderLoop();
+
+private:
+    Scene& scene_;
+    Settings settings_;
+    std::unordered_map<CellCoord, std::unique_ptr<Cell>, CellCoordHash> cells_;
+    // 不处于 eUnloaded 的单元格
+    std::vector<Cell*> active_cells_;
+    uint32_t resident_cell_count_ = 0;
+    uint32_t loading_cell_count_ = 0;
+
+    std::thread loader_thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Cell*> requests_;
+    bool stop_ = false;
+};
+
+}  // namespace wen
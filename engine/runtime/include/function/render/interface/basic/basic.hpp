@@ -26,6 +26,8 @@ private:
     bool suitable(const vk::PhysicalDevice& candidate);
 };
 
+class Image;
+
 class Swapchain {
 public:
     Swapchain();
@@ -40,12 +42,18 @@ public:
     std::vector<vk::Image> images;
     std::vector<vk::ImageView> image_views;
 
+private:
+    void createOffscreenImages();
+
 private:
     struct SwapchainSupportDetails {
         vk::SurfaceCapabilitiesKHR capabilities;
         std::vector<vk::SurfaceFormatKHR> formats;
         std::vector<vk::PresentModeKHR> modes;
     };
+
+    // 离屏模式下代替 swapchain 图像
+    std::vector<std::unique_ptr<Image>> offscreen_images_;
 };
 
 class CommandPool {
@@ -15,6 +15,12 @@ struct Configuration {
     uint32_t max_frames_in_flight = 2;
     uint32_t current_frame_in_flight = 0;
     vk::SampleCountFlagBits msaa_samples = vk::SampleCountFlagBits::e1;
+    // 无窗口模式：不创建 surface 和 swapchain，渲染到离屏颜色附件
+    bool headless = false;
+    // GPU 时间戳查询，需要同时开启 WEN_ENABLE_PROFILER
+    bool enable_gpu_profiler = true;
+    // 额外记录每个子通道的管线统计计数
+    bool enable_pipeline_statistics = false;
     bool msaa() const { return msaa_samples != vk::SampleCountFlagBits::e1; }
 };
 
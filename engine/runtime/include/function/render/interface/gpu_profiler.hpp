@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/profile/profile_system.hpp"
+#include <vulkan/vulkan.hpp>
+
+namespace wen::Renderer {
+
+// GPU 时间戳和管线统计查询，每个 frame in flight 一组查询池
+// 结果在该帧的 fence 等待之后读取，不会阻塞 GPU，通过 ProfileSystem 的 "GPU" 轨道发布
+class GpuProfiler {
+public:
+    static constexpr uint32_t invalid_scope = std::numeric_limits<uint32_t>::max();
+
+    GpuProfiler(uint32_t max_scope_count = 128);
+    ~GpuProfiler();
+
+    // 命令缓冲区开始录制后调用，读取该帧上一次的结果并重置查询池
+    void beginFrame(vk::CommandBuffer cmd, uint32_t frame);
+    // 命令缓冲区结束录制前调用
+    void endFrame(vk::CommandBuffer cmd);
+
+    // name 需要在进程结束前有效，运行时生成的名字用 ProfileSystem::internName 驻留
+    // 管线统计查询不能嵌套，已有统计查询时只记录时间戳
+    uint32_t beginScope(vk::CommandBuffer cmd, const char* name, bool pipeline_statistics = false);
+    void endScope(vk::CommandBuffer cmd, uint32_t scope);
+
+    bool isSupported() const { return supported_; }
+
+private:
+    struct Scope {
+        const char* name;
+        uint32_t depth;
+        uint32_t begin_query;
+        uint32_t end_query;
+        int32_t statistics_query;
+    };
+
+    struct FrameQueries {
+        vk::QueryPool timestamp_pool;
+        vk::QueryPool statistics_pool;
+        std::vector<Scope> scopes;
+        uint32_t timestamp_count = 0;
+        uint32_t statistics_count = 0;
+        uint64_t submit_cpu_ns = 0;
+        bool pending = false;
+    };
+
+    void readback(FrameQueries& frame);
+    const std::array<const char*, 5>& getStatisticsNames(const char* name);
+
+private:
+    bool supported_;
+    bool pipeline_statistics_;
+    uint32_t max_scope_count_;
+    float timestamp_period_;
+    uint64_t timestamp_mask_;
+    std::vector<FrameQueries> frames_;
+    FrameQueries* current_;
+    uint32_t frame_scope_;
+    uint32_t depth_;
+    bool statistics_active_;
+    ProfileThreadBuffer* track_;
+    std::map<const char*, std::array<const char*, 5>> statistics_names_;
+};
+
+}  // namespace wen::Renderer
@@ -3,6 +3,7 @@
 #include "function/render/interface/resource/render_pass.hpp"
 #include "function/render/interface/resource/render_pipeline.hpp"
 #include "function/render/interface/resource/model.hpp"
+#include "function/render/interface/gpu_profiler.hpp"
 
 namespace wen::Renderer {
 
@@ -40,6 +41,10 @@ public:
     void traceRays(const std::shared_ptr<RayTracingRenderPipeline>& render_pipeline, uint32_t width, uint32_t height, uint32_t depth);
     void nextSubpass();
     void nextSubpass(const std::string& name);
+    // 在命令缓冲区中插入 GPU 计时区间，结果发布到 ProfileSystem
+    // name 必须是静态字符串或 ProfileSystem::internName 的返回值
+    uint32_t beginGpuScope(const char* name, bool pipeline_statistics = false);
+    void endGpuScope(uint32_t scope);
     uint32_t registerResourceRecreateCallback(const std::function<void()>& callback);
     void unregisterResourceRecreateCallback(uint32_t callback_id);
 
@@ -54,6 +59,9 @@ public:
     std::shared_ptr<RenderPass> render_pass;
     std::unique_ptr<FramebufferSet> framebuffer_set;
 
+private:
+    void nextFrame();
+
 private:
     uint32_t index_;
 
@@ -66,6 +74,8 @@ private:
     std::vector<vk::Fence> in_flight_fences_;
     std::vector<std::vector<vk::SubmitInfo>> in_flight_submit_infos_;
 
+    std::unique_ptr<GpuProfiler> gpu_profiler_;
+
     uint32_t current_subpass_;
 
     uint32_t current_callback_id_;
@@ -221,6 +221,9 @@ private:
     std::vector<GLTFNode*> nodes_ptr_;
 };
 
+// 在 JobSystem 上分批执行 update(index, begin, end)，index 为批次相对 offset 的起始下标
+void parallelUpdate(uint32_t offset, uint32_t end, uint32_t grain_size, const std::function<void(uint32_t, uint32_t, uint32_t)>& update);
+
 using ClassHashCode = decltype(typeid(int).hash_code());
 template <class T>
 ClassHashCode getClassHashCode() {
@@ -388,24 +391,9 @@ struct CustomDataRegister {
         return custom_data_buffer_map.at(getClassHashCode<CustomData>());
     }
 
-    void multiThreadUpdate(uint32_t id, const std::function<void(uint32_t, uint32_t, uint32_t)>& update) {
-        auto group = groups.at(id);
-        uint32_t begin = group.offset;
-        uint32_t end = begin + group.count;
-        
-        uint32_t index = 0;
-        std::vector<std::thread> threads;
-        while (begin < end) {
-            uint32_t batch_end = std::min(begin + 250, end);
-            threads.emplace_back([=]() {
-                update(index, begin, batch_end);
-            });
-            index += 250;
-            begin = batch_end;
-        }
-        for (auto& thread : threads) {
-            thread.join();
-        }
+    void multiThreadUpdate(uint32_t id, const std::function<void(uint32_t, uint32_t, uint32_t)>& update, uint32_t grain_size = 250) {
+        const auto& group = groups.at(id);
+        parallelUpdate(group.offset, group.offset + group.count, grain_size, update);
     }
 
     std::map<uint32_t, GroupInfo> groups;
@@ -1,15 +1,20 @@
 #pragma once
 
 #include "function/asset/mesh/mesh.hpp"
+#include <glm/mat4x4.hpp>
 
 namespace wen {
 
-// 网格实例 52字节
+// 网格实例 80字节，model 为 TransformHierarchy 计算出的世界矩阵
 struct MeshInstance {
-    alignas(16) glm::vec3 location;
-    alignas(16) glm::vec3 rotation;
-    alignas(16) glm::vec3 scale;
+    alignas(16) glm::mat4 model;
     alignas(4) MeshID mesh_id;
 };
 
+// 快照中一个修改过的实例
+struct MeshInstanceUpdate {
+    uint32_t index;
+    MeshInstance instance;
+};
+
 }  // namespace wen
\ No newline at end of file
@@ -1,26 +1,43 @@
 #pragma once
 
 #include "function/render/mesh/mesh_instance.hpp"
-#include "function/framework/uuid_manager.hpp"
 #include "function/render/interface/resource/buffer.hpp"
+#include <limits>
 
 namespace wen {
 
 // 网格实例池，管理所有的网格实例
+// 逻辑线程只修改 CPU 端的 mesh_instances 并标记修改过的实例，由渲染线程通过快照只上传这些实例
 class MeshInstancePool {
 public:
+    static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
     MeshInstancePool(uint32_t max_mesh_instance_count);
 
-    void createMeshInstance(const MeshInstance& mesh_instance, GameObjectUUID uuid);
-    MeshInstance* getMeshInstancePtr(GameObjectUUID uuid);
+    // 返回实例在 mesh_instances 中的下标，池满时返回 invalid_index
+    uint32_t createMeshInstance(const MeshInstance& mesh_instance);
+    // 释放的槽位清零后优先被 createMeshInstance 复用，current_instance_count 不会减小
+    void destroyMeshInstance(uint32_t index);
+    // 修改 mesh_instances 之后调用
+    void markDirty(uint32_t index);
     void clear();
 
+    // 逻辑线程调用，取出上一次之后修改过的实例
+    void collectUpdates(std::vector<MeshInstanceUpdate>& updates);
+    // 渲染线程调用，将快照中修改过的实例写入缓冲区
+    void upload(uint32_t instance_count, const std::vector<MeshInstanceUpdate>& updates);
+
 public:
     uint32_t current_instance_count;
+    std::vector<MeshInstance> mesh_instances;
     std::shared_ptr<Renderer::Buffer> mesh_instance_buffer;
-    std::map<GameObjectUUID, uint32_t> game_object_uuid_to_mesh_instance_index_map;
-    std::map<uint32_t, GameObjectUUID> mesh_instance_index_to_game_object_uuid_map;
     MeshInstance* mesh_instance_buffer_ptr;
+
+private:
+    uint32_t uploaded_instance_count_;
+    std::vector<uint8_t> dirty_flags_;
+    std::vector<uint32_t> dirty_instances_;
+    std::vector<uint32_t> free_instances_;
 };
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -6,6 +6,8 @@
 namespace wen {
 
 class Subpass {
+    friend class RenderFramework;
+
 public:
     Subpass(const std::string& name, bool only_compute = false) : name_(name), only_compute_(only_compute) {}
     virtual ~Subpass() = default;
@@ -18,12 +20,18 @@ public:
     virtual void executeRenderPass(std::shared_ptr<Renderer::Renderer> renderer, Resource& resource) {}
     virtual void executePostRenderPass(std::shared_ptr<Renderer::Renderer> renderer, Resource& resource) {}
 
-    auto getName() const { return name_; }
+    const auto& getName() const { return name_; }
     auto isOnlyCompute() const { return only_compute_; }
 
 protected:
     std::string name_;
     bool only_compute_;
+
+private:
+    // GPU 计时区间的名字，RenderFramework 创建时驻留一次，每帧直接使用
+    const char* pre_render_pass_scope_ = nullptr;
+    const char* render_pass_scope_ = nullptr;
+    const char* post_render_pass_scope_ = nullptr;
 };
 
 }  // namespace wen
\ No newline at end of file
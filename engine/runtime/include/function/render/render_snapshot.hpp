@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/base/spsc_queue.hpp"
+#include "function/render/mesh/mesh_instance.hpp"
+#include "function/camera/camera_system.hpp"
+
+namespace wen {
+
+// 一帧的渲染快照，逻辑线程写完发布后只读
+struct RenderSnapshot {
+    uint64_t frame_index = 0;
+    float logic_ms = 0.0f;
+    uint32_t mesh_instance_count = 0;
+    // 上一个快照之后修改过的实例，渲染线程按快照顺序写入缓冲区
+    std::vector<MeshInstanceUpdate> mesh_instance_updates;
+    CameraData viewport_camera{};
+    CameraData clip_camera{};
+};
+
+// 逻辑线程与渲染线程之间交换快照，两份快照轮流使用
+// 逻辑线程: acquireWritable -> 填充 -> publish，结束时 close
+// 渲染线程: acquireReadable -> 渲染 -> release，取到 nullptr 表示结束
+class RenderSnapshotQueue {
+public:
+    RenderSnapshotQueue();
+
+    RenderSnapshot* acquireWritable();
+    void publish(RenderSnapshot* snapshot);
+    void close();
+
+    RenderSnapshot* acquireReadable();
+    void release(RenderSnapshot* snapshot);
+
+private:
+    static constexpr size_t snapshot_count = 2;
+
+    std::array<RenderSnapshot, snapshot_count> snapshots_;
+    SPSCQueue<RenderSnapshot*, snapshot_count> free_snapshots_;
+    // 多留一个位置给结束标记
+    SPSCQueue<RenderSnapshot*, snapshot_count + 1> ready_snapshots_;
+};
+
+}  // namespace wen
@@ -3,6 +3,7 @@
 #include "core/base/singleton.hpp"
 #include "function/render/render_framework/render_framework.hpp"
 #include "function/render/render_data.hpp"
+#include "function/render/render_snapshot.hpp"
 
 namespace wen {
 
@@ -13,7 +14,10 @@ class RenderSystem final {
 
 public:
     void createRenderer();
-    void render();
+    // 逻辑线程调用，拷贝当前帧的渲染数据
+    void captureSnapshot(RenderSnapshot& snapshot);
+    // 渲染线程调用，上传快照后录制并提交这一帧
+    void render(const RenderSnapshot& snapshot);
     void destroyRenderer();
 
     uint32_t getMaxMeshInstanceCount() const { return 16384; }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <GLFW/glfw3.h>
+#include <atomic>
 #include <string>
 
 namespace wen {
@@ -24,11 +25,18 @@ public:
     GLFWwindow* getWindow() const { return window_; }
     uint32_t getWidth() const { return width_; }
     uint32_t getHeight() const { return height_; }
+    // 由主线程的回调更新，渲染线程可以安全读取
+    void getFramebufferSize(int& width, int& height) const {
+        width = framebuffer_width_.load(std::memory_order_relaxed);
+        height = framebuffer_height_.load(std::memory_order_relaxed);
+    }
 
 private:
     GLFWwindow* window_;
     uint32_t width_;
     uint32_t height_;
+    std::atomic<int> framebuffer_width_;
+    std::atomic<int> framebuffer_height_;
 };
 
 }  // namespace wen
\ No newline at end of file
@@ -7,12 +7,17 @@ namespace wen {
 
 class WindowSystem final {
     friend class Singleton<WindowSystem>;
-    WindowSystem(const WindowInfo& info);
+    WindowSystem(const WindowInfo& info, bool headless = false);
     ~WindowSystem();
 
 public:
-    void pollEvents() { window_->pollEvents(); }
-    bool shouldClose() const { return window_->shouldClose(); }
+    void pollEvents() {
+        if (window_ != nullptr) {
+            window_->pollEvents();
+        }
+    }
+    bool shouldClose() const { return window_ != nullptr && window_->shouldClose(); }
+    bool isHeadless() const { return window_ == nullptr; }
 
     Window* getRuntimeWindow() const { return window_; }
 
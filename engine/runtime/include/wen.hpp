@@ -4,6 +4,9 @@
 #include "engine/engine.hpp"
 #include "core/reflect/reflect.hpp"
 #include "core/serialize/stream.hpp"
+#include "core/serialize/mapped_stream.hpp"
+#include "core/serialize/tagged.hpp"
+#include "core/serialize/compression.hpp"
 
 #include "function/framework/component/camera/camera_component.hpp"
 #include "function/framework/component/camera/camera_controller_component.hpp"
@@ -0,0 +1,141 @@
+#include "core/job/job_system.hpp"
+#include "core/base/macro.hpp"
+#include "core/profile/profile_system.hpp"
+
+namespace wen {
+
+// 当前线程对应的工作线程下标，非工作线程为 -1
+static thread_local int32_t current_worker_index = -1;
+
+JobSystem::JobSystem(uint32_t worker_count) {
+    if (worker_count == 0) {
+        worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    queues_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+    WEN_CORE_INFO("JobSystem: start {} worker threads", worker_count)
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_ = false;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    queues_.clear();
+}
+
+int32_t JobSystem::getCurrentWorkerIndex() {
+    return current_worker_index;
+}
+
+JobHandle JobSystem::schedule(std::function<void()> job, JobHandle handle) {
+    if (handle == nullptr) {
+        handle = std::make_shared<JobCounter>();
+    }
+    if (workers_.empty()) {
+        job();
+        return handle;
+    }
+    handle->pending_.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t index = current_worker_index >= 0
+                         ? static_cast<uint32_t>(current_worker_index)
+                         : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->jobs.push_back({std::move(job), handle});
+    }
+    queued_job_count_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cv_.notify_one();
+    return handle;
+}
+
+void JobSystem::wait(const JobHandle& handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    uint32_t index = current_worker_index >= 0 ? static_cast<uint32_t>(current_worker_index) : queues_.size();
+    while (!handle->finished()) {
+        if (!tryExecute(index)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    current_worker_index = static_cast<int32_t>(index);
+    WEN_PROFILE_THREAD("Job Worker " + std::to_string(index))
+    while (running_) {
+        if (tryExecute(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this]() {
+            return !running_ || queued_job_count_.load(std::memory_order_acquire) > 0;
+        });
+    }
+    current_worker_index = -1;
+}
+
+bool JobSystem::tryExecute(uint32_t index) {
+    Job job;
+    if (popJob(index, job) || stealJob(index, job)) {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::popJob(uint32_t index, Job& job) {
+    if (index >= queues_.size()) {
+        return false;
+    }
+    // 自己的队列从尾部取，保持局部性
+    auto& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queued_job_count_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::stealJob(uint32_t index, Job& job) {
+    // 从其他线程的队列头部窃取
+    uint32_t count = queues_.size();
+    for (uint32_t i = 1; i <= count; i++) {
+        auto& queue = *queues_[(index + i) % count];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.jobs.empty()) {
+            continue;
+        }
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        queued_job_count_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    job.task();
+    job.handle->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+}  // namespace wen
@@ -0,0 +1,235 @@
+#include "core/profile/profile_system.hpp"
+#include "core/base/macro.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace wen {
+
+namespace {
+
+// 所有线程的缓冲区，线程退出后缓冲区仍保留，保证收集时可以安全读取
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers;
+    std::unordered_set<std::string> names;
+};
+
+ProfileRegistry& registry() {
+    static ProfileRegistry instance;
+    return instance;
+}
+
+void writeJsonString(std::ofstream& file, const std::string& str) {
+    file << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            file << '\\';
+        }
+        file << c;
+    }
+    file << '"';
+}
+
+}  // namespace
+
+ProfileThreadBuffer* ProfileThreadBuffer::current() {
+    static thread_local ProfileThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        buffer = create("");
+    }
+    return buffer;
+}
+
+ProfileThreadBuffer* ProfileThreadBuffer::create(const std::string& name) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& buffer = reg.buffers.emplace_back(std::make_unique<ProfileThreadBuffer>());
+    buffer->thread_id_ = static_cast<uint32_t>(reg.buffers.size());
+    buffer->thread_name_ = name.empty() ? "Thread " + std::to_string(buffer->thread_id_) : name;
+    return buffer.get();
+}
+
+uint64_t ProfileThreadBuffer::now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+ProfileSystem::ProfileSystem() {}
+
+ProfileSystem::~ProfileSystem() {
+    stats_.clear();
+    frame_samples_.clear();
+    captured_events_.clear();
+}
+
+void ProfileSystem::setThreadName(const std::string& name) {
+    auto* buffer = ProfileThreadBuffer::current();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer->thread_name_ = name;
+}
+
+const char* ProfileSystem::internName(const std::string& name) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.names.insert(name).first->c_str();
+}
+
+void ProfileSystem::recordCounter(const char* name, double value) {
+    ProfileThreadBuffer::current()->recordCounter(name, value);
+}
+
+void ProfileSystem::endFrame() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    frame_samples_.clear();
+    frame_counters_.clear();
+    for (auto& buffer : reg.buffers) {
+        uint64_t head = buffer->head_.load(std::memory_order_acquire);
+        uint64_t tail = buffer->tail_.load(std::memory_order_relaxed);
+        for (; tail < head; tail++) {
+            const auto& event = buffer->events_[tail % ProfileThreadBuffer::capacity];
+            if (capturing_ && captured_events_.size() < max_capture_event_count_) {
+                captured_events_.push_back({buffer->thread_id_, event});
+            }
+            if (event.type == ProfileEventType::eCounter) {
+                frame_counters_[event.name] += event.value;
+                continue;
+            }
+            auto iter = stats_.find(event.path);
+            if (iter == stats_.end()) {
+                iter = stats_.insert({event.path, ProfileStats{.name = event.name, .parent = event.parent, .depth = event.depth}}).first;
+            }
+            auto& sample = frame_samples_[event.path];
+            sample.ms += (event.end_ns - event.begin_ns) / 1000000.0;
+            sample.calls++;
+        }
+        buffer->tail_.store(head, std::memory_order_release);
+        uint64_t dropped = buffer->dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            WEN_CORE_WARN("profile buffer of {} is full, {} events dropped", buffer->thread_name_, dropped)
+        }
+    }
+
+    // 同一作用域在一帧内的多次调用累加后再统计 min/avg/max
+    for (auto& [path, sample] : frame_samples_) {
+        auto& stats = stats_.at(path);
+        if (stats.frame_count == 0) {
+            stats.min_ms = sample.ms;
+            stats.max_ms = sample.ms;
+        } else {
+            stats.min_ms = std::min(stats.min_ms, sample.ms);
+            stats.max_ms = std::max(stats.max_ms, sample.ms);
+        }
+        stats.frame_count++;
+        stats.call_count += sample.calls;
+        stats.total_ms += sample.ms;
+    }
+    for (auto& [name, value] : frame_counters_) {
+        auto& stats = counter_stats_[name];
+        if (stats.frame_count == 0) {
+            stats.name = name;
+            stats.min = value;
+            stats.max = value;
+        } else {
+            stats.min = std::min(stats.min, value);
+            stats.max = std::max(stats.max, value);
+        }
+        stats.frame_count++;
+        stats.total += value;
+    }
+    frame_count_++;
+}
+
+void ProfileSystem::beginCapture(uint32_t max_event_count) {
+    capturing_ = true;
+    max_capture_event_count_ = max_event_count;
+    captured_events_.clear();
+    captured_events_.reserve(std::min<uint32_t>(max_event_count, 1 << 16));
+}
+
+bool ProfileSystem::exportChromeTrace(const std::string& filename) {
+    capturing_ = false;
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        WEN_CORE_ERROR("failed to open profile trace file: {}", filename)
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& buffer : reg.buffers) {
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->thread_id_ << ",\"args\":{\"name\":";
+            writeJsonString(file, buffer->thread_name_);
+            file << "}}";
+            first = false;
+        }
+    }
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    for (const auto& [thread_id, event] : captured_events_) {
+        file << (first ? "" : ",") << "\n{\"name\":";
+        writeJsonString(file, event.name);
+        if (event.type == ProfileEventType::eCounter) {
+            file << ",\"ph\":\"C\",\"pid\":0,\"tid\":" << thread_id
+                 << ",\"ts\":" << event.begin_ns / 1000.0
+                 << ",\"args\":{\"value\":" << event.value << "}}";
+        } else {
+            file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_id
+                 << ",\"ts\":" << event.begin_ns / 1000.0
+                 << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.0 << "}";
+        }
+        first = false;
+    }
+    file << "\n]}\n";
+
+    WEN_CORE_INFO("export {} profile events to {}", captured_events_.size(), filename)
+    captured_events_.clear();
+    return true;
+}
+
+void ProfileSystem::report() const {
+    if (frame_count_ == 0) {
+        return;
+    }
+    std::multimap<uint64_t, uint64_t> children;
+    for (const auto& [path, stats] : stats_) {
+        children.insert({stats.parent, path});
+    }
+    WEN_CORE_INFO("PROFILE: {} frames", frame_count_)
+    reportNode(0, children);
+    for (const auto& [name, stats] : counter_stats_) {
+        WEN_CORE_INFO("PROFILE: counter {} avg: {:.1f} min: {:.1f} max: {:.1f}", name, stats.average(), stats.min, stats.max)
+    }
+}
+
+void ProfileSystem::reportNode(uint64_t path, const std::multimap<uint64_t, uint64_t>& children) const {
+    // 子节点按平均耗时从高到低输出
+    std::vector<const std::pair<const uint64_t, ProfileStats>*> nodes;
+    auto [begin, end] = children.equal_range(path);
+    for (auto iter = begin; iter != end; iter++) {
+        nodes.push_back(&*stats_.find(iter->second));
+    }
+    std::sort(nodes.begin(), nodes.end(), [](auto* lhs, auto* rhs) {
+        return lhs->second.averageMs() > rhs->second.averageMs();
+    });
+    for (auto* node : nodes) {
+        const auto& stats = node->second;
+        WEN_CORE_INFO("PROFILE: {:>{}}{} avg(ms): {:.3f} min(ms): {:.3f} max(ms): {:.3f} calls/frame: {:.1f}",
+            "", stats.depth * 2, stats.name, stats.averageMs(), stats.min_ms, stats.max_ms,
+            static_cast<double>(stats.call_count) / stats.frame_count)
+        reportNode(node->first, children);
+    }
+}
+
+void ProfileSystem::reset() {
+    frame_count_ = 0;
+    stats_.clear();
+    frame_samples_.clear();
+    counter_stats_.clear();
+    frame_counters_.clear();
+}
+
+}  // namespace wen
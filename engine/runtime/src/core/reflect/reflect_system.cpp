@@ -5,22 +5,37 @@ namespace wen {
 
 ReflectSystem::ReflectSystem() {}
 
+void ReflectSystem::publish(std::span<const ClassDescriptor* const> classes, std::span<const NameIndex> class_index) {
+    if (!classes_.empty()) {
+        WEN_CORE_ERROR("Reflect properties have been published.")
+        return;
+    }
+    for (size_t i = 1; i < class_index.size(); i++) {
+        if (class_index[i - 1].id >= class_index[i].id) {
+            WEN_CORE_ERROR("Class index is not sorted or {} and {} have the same name hash.",
+                           classes[class_index[i - 1].index]->getClassName(), classes[class_index[i].index]->getClassName())
+            return;
+        }
+    }
+    classes_ = classes;
+    class_index_ = class_index;
+}
+
 const ClassDescriptor& ReflectSystem::getClass(const std::string& name) const {
-    if (classes_.find(name) == classes_.end()) {
+    auto descriptor = findClass(name);
+    if (descriptor == nullptr) {
         WEN_CORE_ERROR("Class {} not found.", name)
         static ClassDescriptor* empty = nullptr;
         return *empty;
     }
-    return *classes_.at(name);
+    return *descriptor;
 }
 
 void ReflectSystem::registerReflectProperties() { Parser(); }
 
 ReflectSystem::~ReflectSystem() {
-    for (auto& [name, descriptor] : classes_) {
-        delete descriptor;
-    }
-    classes_.clear();
+    classes_ = {};
+    class_index_ = {};
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
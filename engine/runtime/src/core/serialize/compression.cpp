@@ -0,0 +1,401 @@
+#include "core/serialize/compression.hpp"
+#include "core/job/job_system.hpp"
+#include "core/base/macro.hpp"
+#include <atomic>
+#include <cstring>
+
+namespace wen {
+
+// 最短匹配长度
+static constexpr size_t min_match = 4;
+// 最后 5 个字节总是字面量，最后一个匹配至少在结尾前 12 个字节开始
+static constexpr size_t last_literals = 5;
+static constexpr size_t match_limit = 12;
+static constexpr size_t max_offset = 65535;
+static constexpr uint32_t hash_bits = 12;
+
+static uint32_t read32(const uint8_t* ptr) {
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static uint32_t hashSequence(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - hash_bits); }
+
+size_t getCompressBound(size_t size) { return size + size / 255 + 16; }
+
+// 返回写入后的位置，放不下时返回 nullptr
+static uint8_t* writeLength(uint8_t* op, uint8_t* end, size_t length) {
+    while (length >= 255) {
+        if (op == end) {
+            return nullptr;
+        }
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op == end) {
+        return nullptr;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+static uint8_t* writeSequence(uint8_t* op, uint8_t* end, const uint8_t* literals, size_t literal_length, size_t offset, size_t match_length) {
+    if (op == end) {
+        return nullptr;
+    }
+    auto* token = op++;
+    *token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+    if (literal_length >= 15 && (op = writeLength(op, end, literal_length - 15)) == nullptr) {
+        return nullptr;
+    }
+    if (static_cast<size_t>(end - op) < literal_length) {
+        return nullptr;
+    }
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+    // 最后一个序列没有匹配
+    if (match_length == 0) {
+        return op;
+    }
+    if (end - op < 2) {
+        return nullptr;
+    }
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    match_length -= min_match;
+    *token |= static_cast<uint8_t>(std::min<size_t>(match_length, 15));
+    if (match_length >= 15 && (op = writeLength(op, end, match_length - 15)) == nullptr) {
+        return nullptr;
+    }
+    return op;
+}
+
+size_t compressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+    auto* op = dst;
+    auto* end = dst + std::min(capacity, size);
+    size_t anchor = 0;
+    if (size > match_limit) {
+        // 记录每个 4 字节序列最近出现的位置
+        uint32_t table[1 << hash_bits] = {};
+        auto limit = size - match_limit;
+        size_t ip = 1;
+        uint32_t misses = 0;
+        table[hashSequence(read32(src))] = 0;
+        while (ip < limit) {
+            auto sequence = read32(src + ip);
+            auto& entry = table[hashSequence(sequence)];
+            size_t ref = entry;
+            entry = static_cast<uint32_t>(ip);
+            if (ip - ref > max_offset || read32(src + ref) != sequence) {
+                // 连续找不到匹配时加大步长，不可压缩的数据很快跳过
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            // 向前延伸到上一个序列的结尾
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                ip--;
+                ref--;
+            }
+            auto length = min_match;
+            while (ip + length < size - last_literals && src[ref + length] == src[ip + length]) {
+                length++;
+            }
+            op = writeSequence(op, end, src + anchor, ip - anchor, ip - ref, length);
+            if (op == nullptr) {
+                return 0;
+            }
+            ip += length;
+            anchor = ip;
+        }
+    }
+    op = writeSequence(op, end, src + anchor, size - anchor, 0, 0);
+    if (op == nullptr || static_cast<size_t>(op - dst) >= size) {
+        return 0;
+    }
+    return static_cast<size_t>(op - dst);
+}
+
+// 返回读取后的位置，越界时返回 nullptr
+static const uint8_t* readLength(const uint8_t* ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip == end) {
+            return nullptr;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return ip;
+}
+
+bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t raw_size) {
+    auto* ip = src;
+    auto* ip_end = src + size;
+    auto* op = dst;
+    auto* op_end = dst + raw_size;
+    while (ip < ip_end) {
+        auto token = *ip++;
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && (ip = readLength(ip, ip_end, literal_length)) == nullptr) {
+            return false;
+        }
+        if (static_cast<size_t>(ip_end - ip) < literal_length || static_cast<size_t>(op_end - op) < literal_length) {
+            return false;
+        }
+        std::memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        // 最后一个序列
+        if (ip == ip_end) {
+            break;
+        }
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+        size_t match_length = token & 15;
+        if (match_length == 15 && (ip = readLength(ip, ip_end, match_length)) == nullptr) {
+            return false;
+        }
+        match_length += min_match;
+        if (static_cast<size_t>(op_end - op) < match_length) {
+            return false;
+        }
+        auto* match = op - offset;
+        if (offset >= match_length) {
+            std::memcpy(op, match, match_length);
+            op += match_length;
+        } else {
+            // 重叠的匹配按字节复制，重复前面的内容
+            for (size_t i = 0; i < match_length; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return op == op_end;
+}
+
+bool CompressedFrame::isCompressed(std::span<const uint8_t> data) {
+    uint32_t value;
+    if (data.size() < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, data.data(), sizeof(value));
+    return value == magic;
+}
+
+// 没有 job_system 时一次只处理一个块
+static uint32_t getBatchSize(JobSystem* job_system) { return job_system != nullptr ? job_system->getWorkerCount() + 1 : 1; }
+
+CompressSink::CompressSink(StreamSink& sink, uint64_t raw_size, size_t block_size, JobSystem* job_system)
+    : sink_(sink), raw_size_(raw_size), block_size_(std::clamp<size_t>(block_size, 1024, CompressedFrame::max_block_size)), job_system_(job_system), blocks_(getBatchSize(job_system)) {
+    for (auto& block : blocks_) {
+        block.raw = std::make_unique_for_overwrite<uint8_t[]>(block_size_);
+        block.packed = std::make_unique_for_overwrite<uint8_t[]>(block_size_);
+    }
+    uint32_t header[] = {CompressedFrame::magic, static_cast<uint32_t>(block_size_)};
+    good_ = sink_.write(header, sizeof(header)) && sink_.write(&raw_size_, sizeof(raw_size_));
+}
+
+CompressSink::~CompressSink() { finish(); }
+
+bool CompressSink::write(const void* data, size_t size) {
+    written_size_ += size;
+    auto bytes = static_cast<const uint8_t*>(data);
+    while (size > 0 && good_ && !finished_) {
+        auto& block = blocks_[block_index_];
+        auto count = std::min(size, block_size_ - block.raw_size);
+        std::memcpy(block.raw.get() + block.raw_size, bytes, count);
+        block.raw_size += count;
+        bytes += count;
+        size -= count;
+        if (block.raw_size == block_size_ && ++block_index_ == blocks_.size()) {
+            good_ = writeBlocks();
+        }
+    }
+    return good_ && !finished_;
+}
+
+bool CompressSink::writeBlocks() {
+    auto count = block_index_ + (block_index_ < blocks_.size() && blocks_[block_index_].raw_size > 0 ? 1 : 0);
+    block_index_ = 0;
+    if (count == 0) {
+        return good_;
+    }
+    auto compress = [this](uint32_t begin, uint32_t end) {
+        for (auto i = begin; i < end; i++) {
+            auto& block = blocks_[i];
+            block.packed_size = compressBlock(block.raw.get(), block.raw_size, block.packed.get(), block_size_);
+        }
+    };
+    if (job_system_ != nullptr) {
+        job_system_->parallelFor(0u, count, 1u, compress);
+    } else {
+        compress(0, count);
+    }
+    bool result = good_;
+    for (uint32_t i = 0; i < count; i++) {
+        auto& block = blocks_[i];
+        // 不可压缩的块原样存储
+        auto packed = block.packed_size != 0;
+        uint32_t header[] = {static_cast<uint32_t>(block.raw_size), packed ? static_cast<uint32_t>(block.packed_size) : (static_cast<uint32_t>(block.raw_size) | CompressedFrame::raw_flag)};
+        result = result && sink_.write(header, sizeof(header));
+        result = result && sink_.write(packed ? block.packed.get() : block.raw.get(), packed ? block.packed_size : block.raw_size);
+        block.raw_size = 0;
+    }
+    return result;
+}
+
+bool CompressSink::flush() {
+    if (finished_) {
+        return good_;
+    }
+    good_ = writeBlocks() && sink_.flush();
+    return good_;
+}
+
+bool CompressSink::finish() {
+    if (finished_) {
+        return good_;
+    }
+    good_ = writeBlocks();
+    finished_ = true;
+    if (written_size_ != raw_size_) {
+        WEN_CORE_ERROR("Compressed frame expects {} bytes but {} were written.", raw_size_, written_size_)
+        good_ = false;
+    }
+    uint32_t end[] = {0, 0};
+    good_ = good_ && sink_.write(end, sizeof(end)) && sink_.flush();
+    return good_;
+}
+
+// 读满 size 字节，source 提前结束时返回 false
+static bool readExact(StreamSource& source, void* data, size_t size) {
+    auto bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        auto count = source.read(bytes, size);
+        if (count == 0) {
+            return false;
+        }
+        bytes += count;
+        size -= count;
+    }
+    return true;
+}
+
+DecompressSource::DecompressSource(StreamSource& source, JobSystem* job_system) : source_(source), job_system_(job_system) {
+    uint32_t header[2];
+    if (!readExact(source_, header, sizeof(header)) || !readExact(source_, &raw_size_, sizeof(raw_size_)) || header[0] != CompressedFrame::magic || header[1] == 0 ||
+        header[1] > CompressedFrame::max_block_size) {
+        WEN_CORE_ERROR("Stream is not a compressed frame.")
+        raw_size_ = 0;
+        good_ = false;
+        finished_ = true;
+        return;
+    }
+    // 总大小不可能超过压缩数据的大小乘以最大压缩比
+    auto source_size = source_.getSize();
+    if (source_size != StreamSource::unknown_size && raw_size_ / CompressedFrame::max_ratio > source_size) {
+        WEN_CORE_ERROR("Compressed frame is corrupted.")
+        raw_size_ = 0;
+        good_ = false;
+        finished_ = true;
+        return;
+    }
+    block_size_ = header[1];
+    blocks_.resize(getBatchSize(job_system));
+}
+
+bool DecompressSource::readBlocks() {
+    block_count_ = 0;
+    block_index_ = 0;
+    block_offset_ = 0;
+    while (!finished_ && block_count_ < blocks_.size()) {
+        uint32_t header[2];
+        if (!readExact(source_, header, sizeof(header))) {
+            good_ = false;
+            break;
+        }
+        if (header[0] == 0) {
+            finished_ = true;
+            // 总大小与帧头不符
+            good_ = decoded_size_ == raw_size_;
+            break;
+        }
+        auto& block = blocks_[block_count_];
+        block.raw_size = header[0];
+        block.stored = (header[1] & CompressedFrame::raw_flag) != 0;
+        block.packed_size = header[1] & ~CompressedFrame::raw_flag;
+        if (block.raw_size > block_size_ || block.packed_size > block_size_ || (block.stored && block.packed_size != block.raw_size) ||
+            block.raw_size > raw_size_ - decoded_size_) {
+            good_ = false;
+            break;
+        }
+        if (block.raw == nullptr) {
+            block.raw = std::make_unique_for_overwrite<uint8_t[]>(block_size_);
+            block.packed = std::make_unique_for_overwrite<uint8_t[]>(block_size_);
+        }
+        // 原样存储的块直接读入
+        if (!readExact(source_, block.stored ? block.raw.get() : block.packed.get(), block.packed_size)) {
+            good_ = false;
+            break;
+        }
+        decoded_size_ += block.raw_size;
+        block_count_++;
+    }
+    if (!good_) {
+        WEN_CORE_ERROR("Compressed frame is corrupted.")
+        finished_ = true;
+        block_count_ = 0;
+        return false;
+    }
+    std::atomic<bool> result = true;
+    auto decompress = [this, &result](uint32_t begin, uint32_t end) {
+        for (auto i = begin; i < end; i++) {
+            auto& block = blocks_[i];
+            if (!block.stored && !decompressBlock(block.packed.get(), block.packed_size, block.raw.get(), block.raw_size)) {
+                result.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (job_system_ != nullptr) {
+        job_system_->parallelFor(0u, block_count_, 1u, decompress);
+    } else {
+        decompress(0, block_count_);
+    }
+    if (!result.load(std::memory_order_relaxed)) {
+        WEN_CORE_ERROR("Compressed frame is corrupted.")
+        good_ = false;
+        finished_ = true;
+        block_count_ = 0;
+    }
+    return block_count_ > 0;
+}
+
+size_t DecompressSource::read(void* data, size_t size) {
+    auto bytes = static_cast<uint8_t*>(data);
+    size_t total = 0;
+    while (total < size) {
+        if (block_index_ == block_count_ && !readBlocks()) {
+            break;
+        }
+        auto& block = blocks_[block_index_];
+        auto count = std::min(size - total, block.raw_size - block_offset_);
+        std::memcpy(bytes + total, block.raw.get() + block_offset_, count);
+        total += count;
+        block_offset_ += count;
+        if (block_offset_ == block.raw_size) {
+            block_index_++;
+            block_offset_ = 0;
+        }
+    }
+    return total;
+}
+
+}  // namespace wen
@@ -0,0 +1,113 @@
+#include "core/serialize/mapped_stream.hpp"
+#include "core/base/macro.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace wen {
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& path) {
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        WEN_CORE_ERROR("Could not open file '{}'", path)
+        return;
+    }
+    file_ = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        WEN_CORE_ERROR("Could not get size of file '{}'", path)
+        return;
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    // 空文件不能映射
+    if (size_ > 0) {
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        auto data = mapping_ != nullptr ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (data == nullptr) {
+            WEN_CORE_ERROR("Could not map file '{}'", path)
+            size_ = 0;
+            return;
+        }
+        data_ = static_cast<const uint8_t*>(data);
+    }
+    is_open_ = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    auto file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        WEN_CORE_ERROR("Could not open file '{}'", path)
+        return;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        WEN_CORE_ERROR("Could not get size of file '{}'", path)
+        close(file);
+        return;
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    // 空文件不能映射，映射建立后可以关闭文件
+    if (size_ > 0) {
+        auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) {
+            WEN_CORE_ERROR("Could not map file '{}'", path)
+            size_ = 0;
+            close(file);
+            return;
+        }
+        data_ = static_cast<const uint8_t*>(data);
+    }
+    close(file);
+    is_open_ = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+#endif
+
+MappedDeserializeStream::MappedDeserializeStream(const std::string& path) : file_(path) {
+    setData(file_.getData());
+    if (!file_.isOpen()) {
+        setFailed();
+    }
+}
+
+std::string_view MappedDeserializeStream::readString() {
+    std::string::size_type length;
+    *this >> length;
+    if (!good() || length > getRemaining()) {
+        setFailed();
+        return {};
+    }
+    return {reinterpret_cast<const char*>(view(length)), length};
+}
+
+}  // namespace wen
@@ -2,36 +2,190 @@
 
 namespace wen {
 
-SerializeStream::SerializeStream() { data_.reserve(32); }
+// 内存模式的初始容量
+static constexpr size_t initial_capacity = 32;
 
-SerializeStream::~SerializeStream() { data_.clear(); }
+SerializeStream::SerializeStream() {
+    buffer_ = std::make_unique_for_overwrite<uint8_t[]>(initial_capacity);
+    cursor_ = buffer_.get();
+    end_ = cursor_ + initial_capacity;
+}
+
+SerializeStream::SerializeStream(StreamSink& sink, size_t buffer_size) : sink_(&sink) {
+    // 至少能放下一个算术类型
+    buffer_size = std::max(buffer_size, sizeof(uint64_t) * 2);
+    buffer_ = std::make_unique_for_overwrite<uint8_t[]>(buffer_size);
+    cursor_ = buffer_.get();
+    end_ = cursor_ + buffer_size;
+}
+
+SerializeStream::~SerializeStream() { flush(); }
 
-void* SerializeStream::getSafePtr(size_t size) {
-    while (data_.size() + size > data_.capacity()) {
-        data_.reserve(static_cast<size_t>(data_.capacity() * 1.5));
+bool SerializeStream::flush() {
+    if (sink_ == nullptr) {
+        return good_;
     }
-    data_.resize(data_.size() + size);
-    return &data_.data()[data_.size() - size];
+    auto size = static_cast<size_t>(cursor_ - buffer_.get());
+    if (size > 0) {
+        good_ = good_ && sink_->write(buffer_.get(), size);
+        flushed_size_ += size;
+        cursor_ = buffer_.get();
+    }
+    good_ = good_ && sink_->flush();
+    return good_;
 }
 
-void SerializeStream::write(const char* buffer, size_t size) {
-    auto ptr = getSafePtr(size);
-    memcpy(ptr, buffer, size);
+void SerializeStream::reserve(size_t size) {
+    auto used = static_cast<size_t>(cursor_ - buffer_.get());
+    auto capacity = static_cast<size_t>(end_ - buffer_.get());
+    if (sink_ != nullptr) {
+        good_ = good_ && sink_->write(buffer_.get(), used);
+        flushed_size_ += used;
+        cursor_ = buffer_.get();
+        return;
+    }
+    auto new_capacity = std::max(capacity * 2, used + size);
+    auto buffer = std::make_unique_for_overwrite<uint8_t[]>(new_capacity);
+    std::memcpy(buffer.get(), buffer_.get(), used);
+    buffer_ = std::move(buffer);
+    cursor_ = buffer_.get() + used;
+    end_ = buffer_.get() + new_capacity;
+}
+
+void SerializeStream::writeSlow(const void* buffer, size_t size) {
+    if (sink_ == nullptr) {
+        reserve(size);
+        std::memcpy(cursor_, buffer, size);
+        cursor_ += size;
+        return;
+    }
+    // 先填满缓冲区，剩余的数据超过缓冲区大小时直接交给 sink
+    auto bytes = static_cast<const uint8_t*>(buffer);
+    auto count = static_cast<size_t>(end_ - cursor_);
+    std::memcpy(cursor_, bytes, count);
+    cursor_ += count;
+    bytes += count;
+    size -= count;
+    reserve(size);
+    if (size >= static_cast<size_t>(end_ - cursor_)) {
+        good_ = good_ && sink_->write(bytes, size);
+        flushed_size_ += size;
+    } else {
+        std::memcpy(cursor_, bytes, size);
+        cursor_ += size;
+    }
 }
 
 DeserializeStream::DeserializeStream(SerializeStream&& stream) {
-    data_ = std::move(stream.data_);
-    offset_ = data_.size();
+    buffer_size_ = static_cast<size_t>(stream.cursor_ - stream.buffer_.get());
+    buffer_ = std::move(stream.buffer_);
+    begin_ = buffer_.get();
+    cursor_ = begin_;
+    end_ = begin_ + buffer_size_;
+    total_size_ = buffer_size_;
+    stream.cursor_ = nullptr;
+    stream.end_ = nullptr;
 }
 
-DeserializeStream::~DeserializeStream() {
-    data_.clear();
-    offset_ = 0;
+DeserializeStream::DeserializeStream(std::vector<uint8_t>&& data) : data_(std::move(data)) {
+    buffer_size_ = data_.size();
+    begin_ = data_.data();
+    cursor_ = begin_;
+    end_ = begin_ + buffer_size_;
+    total_size_ = buffer_size_;
 }
 
-void DeserializeStream::read(void* buffer, size_t size) {
-    offset_ -= size;
-    memcpy(buffer, &data_.data()[offset_], size);
+DeserializeStream::DeserializeStream(StreamSource& source, size_t buffer_size) : source_(&source) {
+    buffer_size_ = std::max(buffer_size, sizeof(uint64_t) * 2);
+    buffer_ = std::make_unique_for_overwrite<uint8_t[]>(buffer_size_);
+    begin_ = buffer_.get();
+    cursor_ = begin_;
+    end_ = begin_;
+    total_size_ = source.getSize();
+}
+
+DeserializeStream::~DeserializeStream() = default;
+
+void DeserializeStream::setData(std::span<const uint8_t> data) {
+    buffer_size_ = data.size();
+    begin_ = data.data();
+    cursor_ = begin_;
+    end_ = begin_ + buffer_size_;
+    total_size_ = buffer_size_;
+    buffer_offset_ = 0;
+    good_ = true;
+}
+
+uint64_t DeserializeStream::getRemaining() const {
+    if (total_size_ == StreamSource::unknown_size) {
+        return StreamSource::unknown_size;
+    }
+    auto position = getPosition();
+    return total_size_ > position ? total_size_ - position : 0;
+}
+
+bool DeserializeStream::refill() {
+    if (source_ == nullptr) {
+        return false;
+    }
+    buffer_offset_ += static_cast<size_t>(end_ - begin_);
+    auto size = source_->read(buffer_.get(), buffer_size_);
+    begin_ = buffer_.get();
+    cursor_ = begin_;
+    end_ = begin_ + size;
+    return size > 0;
+}
+
+void DeserializeStream::readSlow(void* buffer, size_t size) {
+    auto bytes = static_cast<uint8_t*>(buffer);
+    auto total_size = size;
+    while (size > 0) {
+        auto count = std::min(size, static_cast<size_t>(end_ - cursor_));
+        if (count > 0) {
+            std::memcpy(bytes, cursor_, count);
+            cursor_ += count;
+            bytes += count;
+            size -= count;
+        }
+        if (size == 0) {
+            return;
+        }
+        // 大块数据不经过缓冲区，直接从 source 读入
+        if (source_ != nullptr && size >= buffer_size_) {
+            buffer_offset_ += static_cast<size_t>(end_ - begin_);
+            begin_ = cursor_ = end_ = buffer_.get();
+            while (size > 0) {
+                auto read_size = source_->read(bytes, size);
+                if (read_size == 0) {
+                    break;
+                }
+                buffer_offset_ += read_size;
+                bytes += read_size;
+                size -= read_size;
+            }
+            if (size == 0) {
+                return;
+            }
+        }
+        if (!refill()) {
+            break;
+        }
+    }
+    // 不返回只读了一部分的值
+    std::memset(buffer, 0, total_size);
+    good_ = false;
+}
+
+void DeserializeStream::skip(size_t size) {
+    while (size > 0) {
+        auto count = std::min(size, static_cast<size_t>(end_ - cursor_));
+        cursor_ += count;
+        size -= count;
+        if (size > 0 && !refill()) {
+            good_ = false;
+            return;
+        }
+    }
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -0,0 +1,151 @@
+#include "core/serialize/stream_io.hpp"
+#include "core/base/macro.hpp"
+#include "core/profile/profile_system.hpp"
+#include <cstring>
+
+namespace wen {
+
+size_t MemorySource::read(void* data, size_t size) {
+    size = std::min(size, data_.size() - offset_);
+    if (size > 0) {
+        std::memcpy(data, data_.data() + offset_, size);
+        offset_ += size;
+    }
+    return size;
+}
+
+FileSink::FileSink(const std::string& path) : file_(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!file_) {
+        WEN_CORE_ERROR("Could not open file '{}'", path)
+    }
+}
+
+bool FileSink::write(const void* data, size_t size) {
+    file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file_);
+}
+
+bool FileSink::flush() {
+    file_.flush();
+    return static_cast<bool>(file_);
+}
+
+FileSource::FileSource(const std::string& path) : file_(path, std::ios::in | std::ios::binary | std::ios::ate) {
+    if (!file_) {
+        WEN_CORE_ERROR("Could not open file '{}'", path)
+        return;
+    }
+    size_ = static_cast<uint64_t>(file_.tellg());
+    file_.seekg(0, std::ios::beg);
+}
+
+size_t FileSource::read(void* data, size_t size) {
+    file_.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(file_.gcount());
+}
+
+StreamPipe::StreamPipe(size_t chunk_size, uint32_t chunk_count) : chunk_size_(chunk_size), chunks_(std::max(chunk_count, 2u)) {
+    for (auto& chunk : chunks_) {
+        chunk.data = std::make_unique_for_overwrite<uint8_t[]>(chunk_size_);
+    }
+}
+
+bool StreamPipe::commit() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    chunks_[committed_count_ % chunks_.size()].size = write_offset_;
+    committed_count_++;
+    write_offset_ = 0;
+    condition_.notify_all();
+    // 等待下一个块空闲
+    condition_.wait(lock, [this]() { return cancelled_ || committed_count_ - consumed_count_ < chunks_.size(); });
+    return !cancelled_;
+}
+
+bool StreamPipe::write(const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        // 写入方持有的块在提交之前不会被读取
+        auto& chunk = chunks_[committed_count_ % chunks_.size()];
+        auto count = std::min(size, chunk_size_ - write_offset_);
+        std::memcpy(chunk.data.get() + write_offset_, bytes, count);
+        write_offset_ += count;
+        bytes += count;
+        size -= count;
+        if (write_offset_ == chunk_size_ && !commit()) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !cancelled_;
+}
+
+void StreamPipe::close() {
+    if (write_offset_ > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunks_[committed_count_ % chunks_.size()].size = write_offset_;
+        committed_count_++;
+        write_offset_ = 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    condition_.notify_all();
+}
+
+size_t StreamPipe::read(void* data, size_t size) {
+    auto bytes = static_cast<uint8_t*>(data);
+    size_t total = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (total < size) {
+        condition_.wait(lock, [this]() { return cancelled_ || closed_ || consumed_count_ < committed_count_; });
+        if (cancelled_ || consumed_count_ == committed_count_) {
+            break;
+        }
+        // 已经提交的块在读完之前不会被写入，复制时不需要持有锁
+        auto& chunk = chunks_[consumed_count_ % chunks_.size()];
+        lock.unlock();
+        auto count = std::min(size - total, chunk.size - read_offset_);
+        std::memcpy(bytes + total, chunk.data.get() + read_offset_, count);
+        read_offset_ += count;
+        total += count;
+        lock.lock();
+        if (read_offset_ == chunk.size) {
+            read_offset_ = 0;
+            consumed_count_++;
+            condition_.notify_all();
+        }
+    }
+    return total;
+}
+
+void StreamPipe::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    condition_.notify_all();
+}
+
+AsyncFileSource::AsyncFileSource(const std::string& path, size_t chunk_size, uint32_t chunk_count) : file_(path), pipe_(chunk_size, chunk_count) {
+    if (!file_.isOpen()) {
+        pipe_.close();
+        return;
+    }
+    thread_ = std::thread([this, chunk_size]() {
+        WEN_PROFILE_THREAD("Async File Reader")
+        auto buffer = std::make_unique_for_overwrite<uint8_t[]>(chunk_size);
+        while (true) {
+            auto size = file_.read(buffer.get(), chunk_size);
+            if (size == 0 || !pipe_.write(buffer.get(), size)) {
+                break;
+            }
+        }
+        pipe_.close();
+    });
+}
+
+AsyncFileSource::~AsyncFileSource() {
+    pipe_.cancel();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+}  // namespace wen
@@ -0,0 +1,124 @@
+#include "core/serialize/tagged.hpp"
+#include <deque>
+
+namespace wen {
+
+// 字段表每一项的字节数
+static constexpr uint64_t field_size = sizeof(NameID) + sizeof(uint64_t);
+
+static void writeHeader(SerializeStream& stream, uint64_t schema_hash, std::span<const TaggedField> fields, uint64_t data_size) {
+    stream << schema_hash;
+    stream << static_cast<uint64_t>(sizeof(uint32_t) + fields.size() * field_size + data_size);
+    stream << static_cast<uint32_t>(fields.size());
+    for (const auto& field : fields) {
+        stream << field.id << field.size;
+    }
+}
+
+struct TaggedScratch {
+    SerializeStream data;
+    std::vector<TaggedField> fields;
+};
+
+// 当前线程每一层嵌套的临时缓冲区，只增不减，deque 增长时已有元素的地址不变
+static thread_local std::deque<TaggedScratch> scratches;
+static thread_local uint32_t scratch_depth = 0;
+
+TaggedWriter::TaggedWriter(SerializeStream& stream, uint64_t schema_hash) : stream_(stream), schema_hash_(schema_hash) {
+    if (scratch_depth == scratches.size()) {
+        scratches.emplace_back();
+    }
+    auto& scratch = scratches[scratch_depth++];
+    data_ = &scratch.data;
+    fields_ = &scratch.fields;
+    data_->clear();
+    fields_->clear();
+}
+
+TaggedWriter::~TaggedWriter() { scratch_depth--; }
+
+void TaggedWriter::finish() {
+    auto data = data_->getData();
+    writeHeader(stream_, schema_hash_, *fields_, data.size());
+    stream_.write(data.data(), data.size());
+}
+
+void TaggedWriter::writeBulk(SerializeStream& stream, uint64_t schema_hash, std::span<const TaggedField> fields, const void* data, size_t size) {
+    writeHeader(stream, schema_hash, fields, size);
+    stream.write(data, size);
+}
+
+TaggedReader::TaggedReader(DeserializeStream& stream) : stream_(stream) {
+    uint64_t size;
+    stream_ >> schema_hash_ >> size;
+    if (!stream_.good() || size < sizeof(uint32_t) || size > stream_.getRemaining()) {
+        stream_.setFailed();
+        return;
+    }
+    block_end_ = stream_.getPosition() + size;
+    stream_ >> field_count_;
+    if (field_count_ > (size - sizeof(uint32_t)) / field_size) {
+        stream_.setFailed();
+        field_count_ = 0;
+    }
+}
+
+bool TaggedReader::matches(uint64_t schema_hash) {
+    if (!stream_.good()) {
+        return false;
+    }
+    if (schema_hash == schema_hash_) {
+        stream_.skip(field_count_ * field_size);
+        return true;
+    }
+    fields_.resize(field_count_);
+    for (auto& field : fields_) {
+        stream_ >> field.id >> field.size;
+    }
+    field_end_ = stream_.getPosition();
+    return false;
+}
+
+bool TaggedReader::nextField() {
+    auto position = stream_.getPosition();
+    // 上一个字段读取的字节数与字段表不符
+    if (!stream_.good() || position > field_end_) {
+        stream_.setFailed();
+        return false;
+    }
+    stream_.skip(field_end_ - position);
+    if (field_index_ == fields_.size()) {
+        return false;
+    }
+    const auto& field = fields_[field_index_++];
+    if (field.size > block_end_ - field_end_) {
+        stream_.setFailed();
+        return false;
+    }
+    field_id_ = field.id;
+    field_end_ += field.size;
+    return true;
+}
+
+bool TaggedReader::finish() {
+    auto position = stream_.getPosition();
+    if (!stream_.good() || position > block_end_) {
+        stream_.setFailed();
+        return false;
+    }
+    stream_.skip(block_end_ - position);
+    return stream_.good();
+}
+
+bool skipTagged(DeserializeStream& stream) {
+    uint64_t schema_hash, size;
+    stream >> schema_hash >> size;
+    if (!stream.good() || size > stream.getRemaining()) {
+        stream.setFailed();
+        return false;
+    }
+    stream.skip(size);
+    return stream.good();
+}
+
+}  // namespace wen
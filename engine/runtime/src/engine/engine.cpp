@@ -3,9 +3,14 @@
 
 namespace wen {
 
-void Engine::startupEngine() {
+constexpr float fixed_tick_delta_time = 1.0 / 30.0;
+// 一帧内最多追赶的固定帧数，避免卡顿后固定帧越积越多
+constexpr uint32_t max_fixed_tick_count = 5;
+
+void Engine::startupEngine(const EngineConfiguration& config) {
+    config_ = config;
     global_context = new GlobalContext;
-    global_context->startup();
+    global_context->startup(config_);
     global_context->render_system->createRenderer();
     prepareTimer();
     WEN_CORE_INFO("engine startup.")
@@ -20,70 +25,136 @@ void Engine::shutdownEngine() {
 }
 
 void Engine::runEngine() {
+    WEN_PROFILE_THREAD("Main")
+    if (!config_.profile_trace_filename.empty()) {
+        global_context->profile_system->beginCapture();
+    }
     startTimer();
-    while (!global_context->window_system->shouldClose()) {
+    frame_index_ = 0;
+    frame_timings_.clear();
+    if (config_.headless) {
+        frame_timings_.reserve(config_.headless_frame_count);
+    }
+
+    // 主线程负责窗口事件和逻辑，渲染线程落后一帧录制提交
+    snapshot_queue_ = std::make_unique<RenderSnapshotQueue>();
+    render_thread_ = std::make_unique<std::thread>([this]() { renderLoop(); });
+    while (!shouldExit()) {
         global_context->window_system->pollEvents();
         tickOneFrame();
+        global_context->profile_system->endFrame();
+        frame_index_++;
     }
-    fixed_tick_thread_->join();
-    fixed_tick_thread_.reset();
+    snapshot_queue_->close();
+    render_thread_->join();
+    render_thread_.reset();
+    snapshot_queue_.reset();
+
+    // 收集渲染线程最后一帧的事件
+    global_context->profile_system->endFrame();
+    if (!config_.profile_trace_filename.empty()) {
+        global_context->profile_system->exportChromeTrace(config_.profile_trace_filename);
+    }
+    global_context->profile_system->report();
+
+    if (config_.headless) {
+        reportHeadlessTimings();
+    }
+}
+
+bool Engine::shouldExit() const {
+    if (config_.headless) {
+        return frame_index_ >= config_.headless_frame_count;
+    }
+    return global_context->window_system->shouldClose();
 }
 
 void Engine::prepareTimer() {
-    delta_time_ = 0.03f;
+    delta_time_ = config_.headless ? fixed_tick_delta_time : 0.03f;
+    fixed_tick_accumulator_ = 0.0f;
     main_timer_ = global_context->timer_system->registerTimer();
-    fixed_timer_ = global_context->timer_system->registerTimer();
-    benchmark_timer_ = global_context->timer_system->registerTimer();
     stopTimer();
-    fixed_tick_thread_ = std::make_unique<std::thread>([this]() {
-        while (!global_context->window_system->shouldClose()) {
-            if ((!fixed_timer_->stopped()) && (!main_timer_->stopped())) {
-                global_context->scene_manager->fixedTick();
-            }
-            constexpr float fixed_tick_delta_time = 1.0 / 30.0;
-            fixed_timer_->tick(std::chrono::milliseconds(static_cast<int>(fixed_tick_delta_time * 1000)));
-        }
-    });
 }
 
 void Engine::startTimer() {
     global_context->scene_manager->start();
 
     main_timer_->reset();
-    fixed_timer_->reset();
     main_timer_->tick();
-    fixed_timer_->tick();
 }
 
 void Engine::stopTimer() {
     main_timer_->stop();
-    fixed_timer_->stop();
 }
 
 void Engine::tickOneFrame() {
+    // 渲染线程还在使用两份快照时阻塞，逻辑最多领先渲染一帧
+    auto* snapshot = snapshot_queue_->acquireWritable();
+    auto begin = std::chrono::steady_clock::now();
     tickLogic();
-    tickRender();
+    snapshot->frame_index = frame_index_;
+    global_context->render_system->captureSnapshot(*snapshot);
+    snapshot->logic_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    snapshot_queue_->publish(snapshot);
 }
 
 void Engine::tickLogic() {
+    WEN_PROFILE_SCOPE("Engine::tickLogic")
     if (!main_timer_->stopped()) {
         global_context->scene_manager->swap();
-    }
-    benchmark_timer_->tick();
-    if (!main_timer_->stopped()) {
+        // 固定帧和普通帧都在逻辑线程上执行，按累计时间补齐固定帧
+        fixed_tick_accumulator_ += delta_time_;
+        uint32_t fixed_tick_count = 0;
+        while (fixed_tick_accumulator_ >= fixed_tick_delta_time && fixed_tick_count < max_fixed_tick_count) {
+            global_context->scene_manager->fixedTick(fixed_tick_delta_time);
+            fixed_tick_accumulator_ -= fixed_tick_delta_time;
+            fixed_tick_count++;
+        }
+        fixed_tick_accumulator_ = std::min(fixed_tick_accumulator_, fixed_tick_delta_time);
         global_context->scene_manager->tick(delta_time_);
     }
-    float benchmark_dt = benchmark_timer_->tick();
-    WEN_CORE_DEBUG("BENCHMARK: Logic Delta Time(ms): {}", benchmark_dt * 1000)
+    global_context->input_system->tick();
+    if (config_.headless) {
+        // 固定步长，保证每次运行的逻辑结果一致
+        delta_time_ = fixed_tick_delta_time;
+    } else {
+        delta_time_ = main_timer_->tick();
+    }
 }
 
-void Engine::tickRender() {
-    benchmark_timer_->tick();
-    global_context->render_system->render(); 
-    float benchmark_dt = benchmark_timer_->tick();
-    WEN_CORE_DEBUG("BENCHMARK: Render CPU Delta Time(ms): {}", benchmark_dt * 1000)
-    delta_time_ = main_timer_->tick();
-    global_context->input_system->tick();
+void Engine::renderLoop() {
+    WEN_PROFILE_THREAD("Render")
+    while (auto* snapshot = snapshot_queue_->acquireReadable()) {
+        tickRender(*snapshot);
+        snapshot_queue_->release(snapshot);
+    }
+}
+
+void Engine::tickRender(const RenderSnapshot& snapshot) {
+    WEN_PROFILE_SCOPE("Engine::tickRender")
+    auto begin = std::chrono::steady_clock::now();
+    global_context->render_system->render(snapshot);
+    if (config_.headless) {
+        float render_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        frame_timings_.push_back({snapshot.logic_ms, render_ms});
+    }
+}
+
+void Engine::reportHeadlessTimings() const {
+    if (frame_timings_.empty()) {
+        return;
+    }
+    float min_ms = std::numeric_limits<float>::max(), max_ms = 0, total_ms = 0;
+    for (uint32_t i = 0; i < frame_timings_.size(); i++) {
+        const auto& timing = frame_timings_[i];
+        // 两个阶段并行执行，一帧的耗时取决于较慢的一侧
+        float frame_ms = std::max(timing.logic_ms, timing.render_ms);
+        WEN_CORE_INFO("HEADLESS: frame {} logic(ms): {:.3f} render(ms): {:.3f} frame(ms): {:.3f}", i, timing.logic_ms, timing.render_ms, frame_ms)
+        min_ms = std::min(min_ms, frame_ms);
+        max_ms = std::max(max_ms, frame_ms);
+        total_ms += frame_ms;
+    }
+    WEN_CORE_INFO("HEADLESS: {} frames, min(ms): {:.3f} avg(ms): {:.3f} max(ms): {:.3f}", frame_timings_.size(), min_ms, total_ms / frame_timings_.size(), max_ms)
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -4,16 +4,28 @@ namespace wen {
 
 GlobalContext* global_context = nullptr;
 
-void GlobalContext::startup() {
+void GlobalContext::startup(const EngineConfiguration& config) {
     log_system.initialize(LogLevel::trace, LogLevel::trace);
-    window_system.initialize(WindowInfo("wen 16 : 9", 1600, 900));
+    profile_system.initialize();
+    job_system.initialize();
+    window_system.initialize(config.window_info, config.headless);
     event_system.initialize();
     input_system.initialize();
     timer_system.initialize();
     reflect_system.initialize();
-    render_system.initialize(Renderer::Configuration{.debug = true});
+    render_system.initialize(Renderer::Configuration{
+        .debug = config.debug,
+        .swapchain_image_width = config.window_info.width,
+        .swapchain_image_height = config.window_info.height,
+        .is_enable_ray_tracing = config.enable_ray_tracing,
+        .headless = config.headless,
+        .enable_pipeline_statistics = config.enable_pipeline_statistics,
+    });
     game_object_uuid_allocator.initialize();
     component_type_uuid_system.initialize();
+    scene_serializer.initialize();
+    // 注册反射信息和可序列化的组件
+    reflect_system->registerReflectProperties();
     scene_manager.initialize();
     asset_system.initialize();
     camera_system.initialize();
@@ -23,6 +35,7 @@ void GlobalContext::shutdown() {
     camera_system.destroy();
     asset_system.destroy();
     scene_manager.destroy();
+    scene_serializer.destroy();
     component_type_uuid_system.destroy();
     game_object_uuid_allocator.destroy();
     render_system.destroy();
@@ -31,6 +44,8 @@ void GlobalContext::shutdown() {
     input_system.destroy();
     event_system.destroy();
     window_system.destroy();
+    job_system.destroy();
+    profile_system.destroy();
     log_system.destroy();
 }
 
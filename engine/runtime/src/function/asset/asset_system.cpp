@@ -1,5 +1,6 @@
 #include "function/asset/asset_system.hpp"
 #include "core/base/macro.hpp"
+#include "core/profile/profile_system.hpp"
 #include <tiny_obj_loader.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
@@ -50,14 +51,24 @@ AssetSystem::~AssetSystem() {
 }
 
 MeshID AssetSystem::loadMesh(const std::string& filename, const std::vector<std::string>& lods) {
+    WEN_PROFILE_SCOPE("AssetSystem::loadMesh")
+    MeshData data{};
+    if (!importMesh(path_ + "/models/" + filename, lods, data)) {
+        return MeshID(-1);
+    }
+    return mesh_pool_->uploadMeshData(data);
+}
+
+bool AssetSystem::importMesh(const std::string& filepath, const std::vector<std::string>& lods, MeshData& data) {
+    WEN_PROFILE_SCOPE("AssetSystem::importMesh")
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string warn, err;
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, (path_ + "/models/" + filename).c_str())) {
-        WEN_CORE_ERROR("Failed to load mesh: {}", filename)
-        return MeshID(-1);
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str())) {
+        WEN_CORE_ERROR("Failed to load mesh: {}", filepath)
+        return false;
     }
 
     std::vector<size_t> lods_shape_index;
@@ -92,7 +103,6 @@ MeshID AssetSystem::loadMesh(const std::string& filename, const std::vector<std:
         }
     }
 
-    MeshData data{};
     for (auto lod_shape_index : lods_shape_index) {
         auto& primitive = data.lods.emplace_back();
         std::unordered_map<ObjVertex, uint32_t> unique_vertices;
@@ -139,8 +149,7 @@ MeshID AssetSystem::loadMesh(const std::string& filename, const std::vector<std:
             primitive.indices.push_back(unique_vertices.at(vertex));
         }
     }
-
-    return mesh_pool_->uploadMeshData(data);
+    return true;
 }
 
 }  // namespace wen
\ No newline at end of file
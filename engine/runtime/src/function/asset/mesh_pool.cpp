@@ -58,13 +58,11 @@ MeshID MeshPool::uploadMeshData(const MeshData& mesh_data) {
         return -1;
     }
 
-    mesh_descriptor_buffer_ptr->aabb_min = {std::numeric_limits<float>::max(),
-                                            std::numeric_limits<float>::max(),
-                                            std::numeric_limits<float>::max()};
-    mesh_descriptor_buffer_ptr->aabb_max = {std::numeric_limits<float>::min(),
-                                            std::numeric_limits<float>::min(),
-                                            std::numeric_limits<float>::min()};
-    mesh_descriptor_buffer_ptr->radius = 0;
+    MeshBounds bounds{
+        .aabb_min = glm::vec3(std::numeric_limits<float>::max()),
+        .aabb_max = glm::vec3(std::numeric_limits<float>::lowest()),
+        .radius = 0,
+    };
     size_t lod_index = 0;
     for (auto& primitive : mesh_data.lods) {
         position_buffer->setData(primitive.positions, current_vertex_count);
@@ -85,14 +83,19 @@ MeshID MeshPool::uploadMeshData(const MeshData& mesh_data) {
         mesh_descriptor_buffer_ptr->lods[lod_index] = primitive_id;
         lod_index++;
 
+        // 映射的内存只写不读，在 bounds 中累计后一次写入
         for (auto& position : primitive.positions) {
-            mesh_descriptor_buffer_ptr->aabb_min = glm::min(mesh_descriptor_buffer_ptr->aabb_min, position);
-            mesh_descriptor_buffer_ptr->aabb_max = glm::max(mesh_descriptor_buffer_ptr->aabb_max, position);
-            mesh_descriptor_buffer_ptr->radius = std::max(mesh_descriptor_buffer_ptr->radius, glm::dot(position, position));
+            bounds.aabb_min = glm::min(bounds.aabb_min, position);
+            bounds.aabb_max = glm::max(bounds.aabb_max, position);
+            bounds.radius = std::max(bounds.radius, glm::dot(position, position));
         }
     }
+    bounds.radius = std::sqrt(bounds.radius);
     mesh_descriptor_buffer_ptr->lod_count = mesh_data.lods.size();
-    mesh_descriptor_buffer_ptr->radius = std::sqrt(mesh_descriptor_buffer_ptr->radius);
+    mesh_descriptor_buffer_ptr->aabb_min = bounds.aabb_min;
+    mesh_descriptor_buffer_ptr->aabb_max = bounds.aabb_max;
+    mesh_descriptor_buffer_ptr->radius = bounds.radius;
+    mesh_bounds.push_back(bounds);
     mesh_descriptor_buffer_ptr++;
     current_mesh_descriptor_count++;
 
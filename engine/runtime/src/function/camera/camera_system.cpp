@@ -8,6 +8,9 @@ CameraSystem::CameraSystem() {
     current_camera_id_ = 0;
     current_primary_viewport_ = 0;
     fixed_clip_ = false;
+    editor_camera_active_ = false;
+    viewport_camera_data_ = {};
+    clip_camera_data_ = {};
 
     auto interface = global_context->render_system->getInterface();
     viewport_camera_ = interface->createUniformBuffer(sizeof(CameraData));
@@ -47,9 +50,9 @@ void CameraSystem::reportCameraViewMatrix(CameraID id, const glm::mat4& view, bo
         return;
     }
     if (id == current_primary_viewport_ || is_editor_camera) {
-        static_cast<CameraData*>(viewport_camera_->getData())->view = view;
+        viewport_camera_data_.view = view;
         if (!fixed_clip_) {
-            memcpy(clip_camera_->getData(), &cameras_.at(id).view, sizeof(glm::mat4));
+            clip_camera_data_.view = view;
         }
     }
 }
@@ -69,13 +72,13 @@ void CameraSystem::reportCameraProjectMatrix(CameraID id, const glm::mat4& proje
         return;
     }
     if (id == current_primary_viewport_ || is_editor_camera) {
-        static_cast<CameraData*>(viewport_camera_->getData())->project = project;
-        static_cast<CameraData*>(viewport_camera_->getData())->near = near;
-        static_cast<CameraData*>(viewport_camera_->getData())->far = far;
+        viewport_camera_data_.project = project;
+        viewport_camera_data_.near = near;
+        viewport_camera_data_.far = far;
         if (!fixed_clip_) {
-            static_cast<CameraData*>(clip_camera_->getData())->project = project;
-            static_cast<CameraData*>(clip_camera_->getData())->near = near;
-            static_cast<CameraData*>(clip_camera_->getData())->far = far;
+            clip_camera_data_.project = project;
+            clip_camera_data_.near = near;
+            clip_camera_data_.far = far;
         }
     }
 }
@@ -85,9 +88,9 @@ void CameraSystem::reportCameraAsPrimaryViewport(CameraID id) {
     if (editor_camera_active_) {
         return;
     }
-    memcpy(viewport_camera_->getData(), &cameras_.at(id), sizeof(CameraData));
+    viewport_camera_data_ = cameras_.at(id);
     if (!fixed_clip_) {
-        memcpy(clip_camera_->getData(), &cameras_.at(id), sizeof(CameraData));
+        clip_camera_data_ = cameras_.at(id);
     }
 }
 
@@ -97,14 +100,14 @@ void CameraSystem::turnOnFixedClip() {
 
 void CameraSystem::turnOffFixedClip() {
     fixed_clip_ = false;
-    memcpy(clip_camera_->getData(), viewport_camera_->getData(), sizeof(CameraData));
+    clip_camera_data_ = viewport_camera_data_;
 }
 
 void CameraSystem::activeEditorCamera(CameraID id) {
     editor_camera_active_ = true;
-    memcpy(viewport_camera_->getData(), &cameras_.at(id), sizeof(CameraData));
+    viewport_camera_data_ = cameras_.at(id);
     if (!fixed_clip_) {
-        memcpy(clip_camera_->getData(), &cameras_.at(id), sizeof(CameraData));
+        clip_camera_data_ = cameras_.at(id);
     }
 }
 
@@ -113,4 +116,9 @@ void CameraSystem::deactiveEditorCamera() {
     reportCameraAsPrimaryViewport(current_primary_viewport_);
 }
 
+void CameraSystem::upload(const CameraData& viewport_camera, const CameraData& clip_camera) {
+    memcpy(viewport_camera_->getData(), &viewport_camera, sizeof(CameraData));
+    memcpy(clip_camera_->getData(), &clip_camera, sizeof(CameraData));
+}
+
 }  // namespace wen
\ No newline at end of file
@@ -3,6 +3,9 @@
 namespace wen {
 
 EventSystem::EventSystem() {
+    if (global_context->window_system->isHeadless()) {
+        return;
+    }
     auto* window = global_context->window_system->getRuntimeWindow()->getWindow();
 
     glfwSetWindowCloseCallback(window, [](GLFWwindow*) {
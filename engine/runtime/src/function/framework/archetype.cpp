@@ -0,0 +1,220 @@
+#include "function/framework/archetype.hpp"
+#include "core/base/macro.hpp"
+
+namespace wen {
+
+ComponentColumn::ComponentColumn(ComponentColumn&& rhs) noexcept : info_(rhs.info_), chunks_(std::move(rhs.chunks_)) {
+    rhs.chunks_.clear();
+}
+
+ComponentColumn::~ComponentColumn() {
+    for (auto* chunk : chunks_) {
+        ::operator delete(chunk, std::align_val_t(info_.alignment));
+    }
+    chunks_.clear();
+}
+
+void ComponentColumn::allocateChunk(uint32_t row_count) {
+    chunks_.push_back(static_cast<uint8_t*>(::operator new(static_cast<size_t>(info_.size) * row_count, std::align_val_t(info_.alignment))));
+}
+
+Archetype::Archetype(std::vector<ComponentTypeInfo> infos) {
+    std::sort(infos.begin(), infos.end(), [](const auto& lhs, const auto& rhs) { return lhs.uuid < rhs.uuid; });
+    types_.reserve(infos.size());
+    columns_.reserve(infos.size());
+    for (const auto& info : infos) {
+        types_.push_back(info.uuid);
+        columns_.emplace_back(info);
+    }
+    column_index_.assign(types_.empty() ? 0 : types_.back() + 1, invalid_column);
+    for (uint32_t column = 0; column < types_.size(); column++) {
+        column_index_[types_[column]] = column;
+    }
+}
+
+uint32_t Archetype::allocateRow(GameObject* game_object) {
+    alive_count_++;
+    if (!free_rows_.empty()) {
+        uint32_t row = free_rows_.back();
+        free_rows_.pop_back();
+        game_objects_[row] = game_object;
+        return row;
+    }
+    uint32_t row = getRowCount();
+    if (row % chunk_row_count == 0) {
+        for (auto& column : columns_) {
+            column.allocateChunk(chunk_row_count);
+        }
+    }
+    game_objects_.push_back(game_object);
+    return row;
+}
+
+void Archetype::freeRow(uint32_t row) {
+    game_objects_[row] = nullptr;
+    free_rows_.push_back(row);
+    alive_count_--;
+}
+
+ArchetypeStorage::~ArchetypeStorage() {
+    // 组件由 GameObject 析构，这里只检查是否有遗漏
+    for (const auto& archetype : archetypes_) {
+        if (archetype->getAliveCount() != 0) {
+            WEN_CORE_ERROR("archetype storage destroyed with {} alive rows", archetype->getAliveCount())
+        }
+    }
+    archetype_map_.clear();
+    archetypes_.clear();
+}
+
+Component* ArchetypeStorage::insertComponent(GameObject* game_object, EntityLocation& location, const ComponentTypeInfo& info, void* src) {
+    if (location.archetype == nullptr) {
+        location.archetype = getArchetype({info});
+        location.row = location.archetype->allocateRow(game_object);
+    } else {
+        moveRow(location, getAddTarget(location.archetype, info));
+    }
+    void* dst = location.archetype->getComponent(location.archetype->findColumn(info.uuid), location.row);
+    info.move_construct(dst, src);
+    return info.to_component(dst);
+}
+
+void ArchetypeStorage::insertComponents(GameObject* game_object, EntityLocation& location, const ComponentTypeInfo* infos, void* const* srcs, Component** results, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // 沿增加组件的边找到最终的 archetype，中间的 archetype 只查找不移动
+    Archetype* target = location.archetype;
+    for (size_t i = 0; i < count; i++) {
+        target = target == nullptr ? getArchetype({infos[i]}) : getAddTarget(target, infos[i]);
+    }
+    if (location.archetype == nullptr) {
+        location.archetype = target;
+        location.row = target->allocateRow(game_object);
+    } else {
+        moveRow(location, target);
+    }
+    for (size_t i = 0; i < count; i++) {
+        void* dst = target->getComponent(target->findColumn(infos[i].uuid), location.row);
+        infos[i].move_construct(dst, srcs[i]);
+        results[i] = infos[i].to_component(dst);
+    }
+}
+
+Archetype* ArchetypeStorage::allocateRows(const std::vector<ComponentTypeInfo>& infos, GameObject* const* game_objects, uint32_t count, EntityLocation* locations) {
+    auto* archetype = getArchetype(infos);
+    archetype->reserveRows(count);
+    for (uint32_t i = 0; i < count; i++) {
+        locations[i] = {archetype, archetype->allocateRow(game_objects[i])};
+    }
+    return archetype;
+}
+
+void ArchetypeStorage::eraseComponent(EntityLocation& location, ComponentTypeUUID uuid) {
+    auto* target = getRemoveTarget(location.archetype, uuid);
+    if (target == nullptr) {
+        erase(location);
+        return;
+    }
+    moveRow(location, target);
+}
+
+void ArchetypeStorage::erase(EntityLocation& location) {
+    auto* archetype = location.archetype;
+    if (archetype == nullptr) {
+        return;
+    }
+    for (uint32_t column = 0; column < archetype->columns_.size(); column++) {
+        archetype->columns_[column].getInfo().destroy(archetype->getComponent(column, location.row));
+    }
+    archetype->freeRow(location.row);
+    location = {};
+}
+
+Component* ArchetypeStorage::getComponent(const EntityLocation& location, ComponentTypeUUID uuid) const {
+    if (location.archetype == nullptr) {
+        return nullptr;
+    }
+    uint32_t column = location.archetype->findColumn(uuid);
+    if (column == Archetype::invalid_column) {
+        return nullptr;
+    }
+    return location.archetype->getComponentBase(column, location.row);
+}
+
+bool ArchetypeStorage::findColumns(const Archetype* archetype, const ComponentTypeUUID* uuids, uint32_t* columns, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        columns[i] = archetype->findColumn(uuids[i]);
+        if (columns[i] == Archetype::invalid_column) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Archetype* ArchetypeStorage::getArchetype(std::vector<ComponentTypeInfo> infos) {
+    std::vector<ComponentTypeUUID> types;
+    types.reserve(infos.size());
+    for (const auto& info : infos) {
+        types.push_back(info.uuid);
+    }
+    std::sort(types.begin(), types.end());
+    if (auto iter = archetype_map_.find(types); iter != archetype_map_.end()) {
+        return iter->second;
+    }
+    auto* archetype = archetypes_.emplace_back(std::make_unique<Archetype>(std::move(infos))).get();
+    archetype_map_.insert({std::move(types), archetype});
+    return archetype;
+}
+
+Archetype* ArchetypeStorage::getAddTarget(Archetype* archetype, const ComponentTypeInfo& info) {
+    if (auto iter = archetype->add_edges_.find(info.uuid); iter != archetype->add_edges_.end()) {
+        return iter->second;
+    }
+    std::vector<ComponentTypeInfo> infos;
+    infos.reserve(archetype->columns_.size() + 1);
+    for (const auto& column : archetype->columns_) {
+        infos.push_back(column.getInfo());
+    }
+    infos.push_back(info);
+    auto* target = getArchetype(std::move(infos));
+    archetype->add_edges_.insert({info.uuid, target});
+    target->remove_edges_.insert({info.uuid, archetype});
+    return target;
+}
+
+Archetype* ArchetypeStorage::getRemoveTarget(Archetype* archetype, ComponentTypeUUID uuid) {
+    if (auto iter = archetype->remove_edges_.find(uuid); iter != archetype->remove_edges_.end()) {
+        return iter->second;
+    }
+    std::vector<ComponentTypeInfo> infos;
+    for (const auto& column : archetype->columns_) {
+        if (column.getInfo().uuid != uuid) {
+            infos.push_back(column.getInfo());
+        }
+    }
+    auto* target = infos.empty() ? nullptr : getArchetype(std::move(infos));
+    archetype->remove_edges_.insert({uuid, target});
+    if (target != nullptr) {
+        target->add_edges_.insert({uuid, archetype});
+    }
+    return target;
+}
+
+void ArchetypeStorage::moveRow(EntityLocation& location, Archetype* target) {
+    auto* source = location.archetype;
+    uint32_t row = target->allocateRow(source->game_objects_[location.row]);
+    for (uint32_t column = 0; column < source->columns_.size(); column++) {
+        const auto& info = source->columns_[column].getInfo();
+        void* src = source->getComponent(column, location.row);
+        uint32_t target_column = target->findColumn(info.uuid);
+        if (target_column != Archetype::invalid_column) {
+            info.move_construct(target->getComponent(target_column, row), src);
+        }
+        info.destroy(src);
+    }
+    source->freeRow(location.row);
+    location = {target, row};
+}
+
+}  // namespace wen
@@ -0,0 +1,37 @@
+#include "function/framework/component_change_tracker.hpp"
+
+namespace wen {
+
+void ComponentChangeTracker::markChanged(ComponentTypeUUID type, GameObjectHandle handle) {
+    if (type >= types_.size()) {
+        types_.resize(type + 1);
+    }
+    auto& changes = types_[type];
+    if (handle.index >= changes.positions.size()) {
+        changes.positions.resize(handle.index + 1, 0);
+    }
+    auto& position = changes.positions[handle.index];
+    if (position != 0) {
+        // 同一帧内槽位被销毁后复用时记录新的 handle
+        changes.changed[position - 1] = handle;
+        return;
+    }
+    if (changes.changed.empty()) {
+        changed_types_.push_back(type);
+    }
+    changes.changed.push_back(handle);
+    position = static_cast<uint32_t>(changes.changed.size());
+}
+
+void ComponentChangeTracker::clear() {
+    for (auto type : changed_types_) {
+        auto& changes = types_[type];
+        for (auto handle : changes.changed) {
+            changes.positions[handle.index] = 0;
+        }
+        changes.changed.clear();
+    }
+    changed_types_.clear();
+}
+
+}  // namespace wen
@@ -0,0 +1,30 @@
+#include "function/framework/entity_command_buffer.hpp"
+
+namespace wen {
+
+EntityCommandBuffer::~EntityCommandBuffer() {
+    clear();
+}
+
+CommandTarget EntityCommandBuffer::spawn(const std::string& name) {
+    CommandTarget target;
+    target.spawn_index = static_cast<uint32_t>(spawn_names_.size());
+    spawn_names_.push_back(name);
+    record(CommandType::eSpawn, target, {}, nullptr);
+    return target;
+}
+
+void EntityCommandBuffer::destroy(CommandTarget target) {
+    record(CommandType::eDestroy, target, {}, nullptr);
+}
+
+void EntityCommandBuffer::clear() {
+    // 没有回放的组件仍归缓冲所有
+    for (auto& command : commands_) {
+        delete command.component;
+    }
+    commands_.clear();
+    spawn_names_.clear();
+}
+
+}  // namespace wen
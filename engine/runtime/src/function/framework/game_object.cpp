@@ -7,79 +7,116 @@ void RTTI::setupRTTI() {
     descriptor_ = &global_context->reflect_system->getClass(getClassName());
 }
 
-GameObject::GameObject(const std::string& name) : name_(name) {
+void Component::markChanged() {
+    game_object_->getScene()->getChangeTracker().markChanged(uuid_, game_object_->getHandle());
+}
+
+GameObject::GameObject(const std::string& name, Scene& scene, GameObjectHandle handle) : handle_(handle), name_(name), scene_(&scene), storage_(&scene.getStorage()) {
     uuid_ = global_context->game_object_uuid_allocator->allocate();
 }
 
 GameObject::~GameObject() {
-    for (auto& component : components_) {
-        component->onDestroy();
-        delete component;
-    }
-    components_.clear();
-    component_map_.clear();
+    forEachComponent([](Component* component) { component->onDestroy(); });
+    storage_->erase(location_);
 }
 
 void GameObject::awake() {
-    for (auto* component : components_) {
-        component->onAwake();
-    }
+    forEachComponent([](Component* component) { component->onAwake(); });
 }
 
 void GameObject::start() {
-    for (auto* component : components_) {
-        component->onStart();
-    }
+    forEachComponent([](Component* component) { component->onStart(); });
 }
 
 void GameObject::fixedTick() {
-    for (auto* component : components_) {
-        component->onFixedTick();
-    }
+    forEachComponent([](Component* component) { component->onFixedTick(); });
 }
 
 void GameObject::tick(float dt) {
-    for (auto* component : components_) {
-        component->onTick(dt);
-    }
+    forEachComponent([dt](Component* component) { component->onTick(dt); });
 }
 
 void GameObject::postTick(float dt) {
-    for (auto* component : components_) {
-        component->onPostTick(dt);
+    forEachComponent([dt](Component* component) { component->onPostTick(dt); });
+}
+
+bool GameObject::checkComponent(Component* component, const ComponentTypeInfo& info) {
+    if (typeid(*component) != *info.type) {
+        WEN_CORE_ERROR("component {} must be added as its own type in game object {}.", component->getClassName(), name_)
+        return false;
+    }
+    if (storage_->getComponent(location_, info.uuid) != nullptr) {
+        WEN_CORE_ERROR("component with uuid {} already exists in game object {}.", info.uuid, name_)
+        return false;
     }
+    return true;
 }
 
-void GameObject::addComponent(Component* component) {
-    component->uuid_ = global_context->component_type_uuid_system->get(component->getClassName());
-    if (component_map_.find(component->getComponentTypeUUID()) != component_map_.end()) {
-        WEN_CORE_ERROR("component with uuid {} already exists in game object {}.", component->getComponentTypeUUID(), name_)
-        return;
+Component* GameObject::insertComponent(Component* component, ComponentTypeInfo info) {
+    if (!checkComponent(component, info)) {
+        return nullptr;
     }
+    component->uuid_ = info.uuid;
     component->game_object_ = this;
     component->setupRTTI();
-    component_map_.insert({component->getComponentTypeUUID(), component});
-    components_.push_back(component);
-    component->onCreate();
+    auto* stored = storage_->insertComponent(this, location_, info, dynamic_cast<void*>(component));
+    stored->onCreate();
+    return stored;
+}
+
+void GameObject::insertComponents(const std::vector<std::pair<Component*, ComponentTypeInfo>>& components) {
+    std::vector<Component*> sources;
+    std::vector<ComponentTypeInfo> infos;
+    std::vector<void*> srcs;
+    sources.reserve(components.size());
+    infos.reserve(components.size());
+    srcs.reserve(components.size());
+    for (const auto& [component, info] : components) {
+        if (!checkComponent(component, info)) {
+            delete component;
+            continue;
+        }
+        auto uuid = info.uuid;
+        if (std::any_of(infos.begin(), infos.end(), [uuid](const auto& added) { return added.uuid == uuid; })) {
+            WEN_CORE_ERROR("component with uuid {} already exists in game object {}.", uuid, name_)
+            delete component;
+            continue;
+        }
+        component->uuid_ = uuid;
+        component->game_object_ = this;
+        component->setupRTTI();
+        sources.push_back(component);
+        infos.push_back(info);
+        srcs.push_back(dynamic_cast<void*>(component));
+    }
+    std::vector<Component*> stored(infos.size());
+    storage_->insertComponents(this, location_, infos.data(), srcs.data(), stored.data(), infos.size());
+    for (auto* component : sources) {
+        delete component;
+    }
+    for (auto* component : stored) {
+        component->onCreate();
+    }
 }
 
 void GameObject::removeComponent(Component* component) {
     auto uuid = component->getComponentTypeUUID();
-    auto iter = component_map_.find(uuid);
-    if (iter == component_map_.end()) {
+    if (storage_->getComponent(location_, uuid) != component) {
         WEN_CORE_ERROR("component with uuid {} does not exist in game object {}.", uuid, name_)
         return;
     }
-    components_.remove(iter->second);
-    component_map_.erase(iter);
+    component->onDestroy();
+    storage_->eraseComponent(location_, uuid);
 }
 
 Component* GameObject::queryComponent(const std::string& class_name) {
-    auto uuid = global_context->component_type_uuid_system->get(class_name);
-    if (auto iter = component_map_.find(uuid); iter != component_map_.end()) {
-        return component_map_.at(uuid);
-    }
-    return nullptr;
+    return storage_->getComponent(location_, global_context->component_type_uuid_system->get(class_name));
+}
+
+std::vector<Component*> GameObject::getComponents() const {
+    std::vector<Component*> components;
+    forEachComponent([&](Component* component) { components.push_back(component); });
+    return components;
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -0,0 +1,62 @@
+#include "function/framework/game_object_pool.hpp"
+
+namespace wen {
+
+GameObjectPool::~GameObjectPool() {
+    clear();
+    chunks_.clear();
+}
+
+GameObject* GameObjectPool::create(const std::string& name, Scene& scene) {
+    uint32_t index = free_head_;
+    if (index != GameObjectHandle::invalid_index) {
+        free_head_ = getSlot(index).next_free;
+    } else {
+        index = slot_count_++;
+        if (index / chunk_slot_count >= chunks_.size()) {
+            chunks_.push_back(std::make_unique<Slot[]>(chunk_slot_count));
+        }
+    }
+    auto& slot = getSlot(index);
+    auto* game_object = new (slot.storage) GameObject(name, scene, {index, slot.generation});
+    slot.alive = true;
+    slot.next_free = GameObjectHandle::invalid_index;
+    alive_count_++;
+    return game_object;
+}
+
+void GameObjectPool::reserve(uint32_t count) {
+    // 空闲链表和已分配块中未使用的槽位都可以直接使用
+    auto available = static_cast<uint32_t>(chunks_.size()) * chunk_slot_count - alive_count_;
+    while (available < count) {
+        chunks_.push_back(std::make_unique<Slot[]>(chunk_slot_count));
+        available += chunk_slot_count;
+    }
+}
+
+bool GameObjectPool::destroy(GameObjectHandle handle) {
+    auto* game_object = get(handle);
+    if (game_object == nullptr) {
+        return false;
+    }
+    auto& slot = getSlot(handle.index);
+    // 先让 handle 失效，析构过程中的查询不会再拿到这个对象
+    slot.alive = false;
+    slot.generation++;
+    alive_count_--;
+    game_object->~GameObject();
+    slot.next_free = free_head_;
+    free_head_ = handle.index;
+    return true;
+}
+
+void GameObjectPool::clear() {
+    for (uint32_t index = 0; index < slot_count_; index++) {
+        auto& slot = getSlot(index);
+        if (slot.alive) {
+            destroy({index, slot.generation});
+        }
+    }
+}
+
+}  // namespace wen
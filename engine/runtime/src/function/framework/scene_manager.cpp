@@ -1,62 +1,221 @@
 #include "function/framework/scene_manager.hpp"
+#include "function/framework/component/mesh/mesh_component.hpp"
+#include "function/framework/component/camera/camera_controller_component.hpp"
 #include "engine/global_context.hpp"
 
 namespace wen {
 
-Scene::~Scene() {
-    for (auto& game_object : game_objects_) {
-        delete game_object;
+Scene::Scene(const std::string& name) : name_(name) {
+    scheduler_.addSystem(SystemPhase::eFixedTick, std::make_unique<LegacyComponentSystem>(SystemPhase::eFixedTick));
+    scheduler_.addSystem(SystemPhase::eTick, std::make_unique<LegacyComponentSystem>(SystemPhase::eTick));
+    scheduler_.addSystem(SystemPhase::ePostTick, std::make_unique<LegacyComponentSystem>(SystemPhase::ePostTick));
+    auto buffer_count = getJobSystem().getWorkerCount() + 1;
+    for (uint32_t i = 0; i < buffer_count; i++) {
+        command_buffers_.push_back(std::make_unique<EntityCommandBuffer>());
     }
+}
+
+Scene::~Scene() {
+    world_partition_.reset();
+    pending_destroy_.clear();
     game_objects_.clear();
-    game_object_map_.clear();
 }
 
 void Scene::awake() {
-    for (auto* game_object : game_objects_) {
-        game_object->awake();
-    }
+    storage_.forEachComponent([](Component* component) { component->onAwake(); });
 }
 
 void Scene::start() {
-    for (auto* game_object : game_objects_) {
-        game_object->start();
-    }
+    storage_.forEachComponent([](Component* component) { component->onStart(); });
 }
 
-void Scene::fixedTick() {
-    for (auto* game_object : game_objects_) {
-        game_object->fixedTick();
+void Scene::startGameObjects(const std::vector<GameObjectHandle>& handles) {
+    for (auto handle : handles) {
+        if (auto* game_object = game_objects_.get(handle); game_object != nullptr) {
+            game_object->forEachComponent([](Component* component) { component->onAwake(); });
+        }
+    }
+    for (auto handle : handles) {
+        if (auto* game_object = game_objects_.get(handle); game_object != nullptr) {
+            game_object->forEachComponent([](Component* component) { component->onStart(); });
+        }
     }
 }
 
+void Scene::fixedTick(float dt) {
+    scheduler_.run(SystemPhase::eFixedTick, *this, dt);
+}
+
 void Scene::tick(float dt) {
-    for (auto* game_object : game_objects_) {
-        game_object->tick(dt);
-    }
+    scheduler_.run(SystemPhase::eTick, *this, dt);
 }
 
 void Scene::postTick(float dt) {
-    for (auto* game_object : game_objects_) {
-        game_object->postTick(dt);
-    }
+    scheduler_.run(SystemPhase::ePostTick, *this, dt);
+}
+
+WorldPartition* Scene::enableWorldPartition(const WorldPartition::Settings& settings) {
+    world_partition_ = std::make_unique<WorldPartition>(*this, settings);
+    return world_partition_.get();
+}
+
+JobSystem& Scene::getJobSystem() {
+    return *global_context->job_system;
 }
 
 GameObject* Scene::createGameObject(const std::string& name) {
-    auto* game_object = new GameObject(name);
-    game_object_map_.insert({game_object->getUUID(), game_object});
-    game_objects_.push_back(game_object);
-    return game_object;
+    return game_objects_.create(name, *this);
 }
 
 void Scene::removeGameObject(GameObject* game_object) {
-    auto uuid = game_object->getUUID();
-    auto iter = game_object_map_.find(uuid);
-    if (iter == game_object_map_.end()) {
-        WEN_CORE_ERROR("game object with uuid {} does not exist in scene {}.", uuid, name_)
+    auto handle = game_object->getHandle();
+    if (game_objects_.get(handle) != game_object) {
+        WEN_CORE_ERROR("game object with uuid {} does not exist in scene {}.", game_object->getUUID(), name_)
         return;
     }
-    game_objects_.remove(iter->second);
-    game_object_map_.erase(iter);
+    game_objects_.destroy(handle);
+}
+
+bool Scene::save(const std::string& path, bool compress) {
+    return global_context->scene_serializer->save(*this, path, compress);
+}
+
+void Scene::destroyGameObject(GameObjectHandle handle) {
+    if (game_objects_.isValid(handle)) {
+        pending_destroy_.push_back(handle);
+    }
+}
+
+void Scene::flushDestroyedGameObjects() {
+    // onDestroy 中可能继续销毁其他 GameObject，按下标遍历
+    for (size_t i = 0; i < pending_destroy_.size(); i++) {
+        game_objects_.destroy(pending_destroy_[i]);
+    }
+    pending_destroy_.clear();
+}
+
+void Scene::playbackCommandBuffers() {
+    WEN_PROFILE_SCOPE("Scene::playbackCommandBuffers")
+    // 回放时 onCreate、onDestroy 记录的命令留到下一个同步点
+    auto buffer_count = static_cast<uint32_t>(command_buffers_.size());
+    std::vector<EntityCommandBuffer> buffers(buffer_count);
+    for (uint32_t b = 0; b < buffer_count; b++) {
+        buffers[b].swap(*command_buffers_[b]);
+    }
+    scheduler_.resetRunCount();
+    playback(buffers.data(), buffer_count, nullptr);
+}
+
+void Scene::playbackCommandBuffer(EntityCommandBuffer& buffer, std::vector<GameObjectHandle>* spawned_game_objects) {
+    EntityCommandBuffer local;
+    local.swap(buffer);
+    playback(&local, 1, spawned_game_objects);
+}
+
+void Scene::playback(EntityCommandBuffer* buffers, uint32_t buffer_count, std::vector<GameObjectHandle>* spawned_game_objects) {
+    struct Entry {
+        uint64_t sort_key;
+        uint32_t buffer;
+        uint32_t command;
+    };
+    std::vector<Entry> entries;
+    uint32_t spawn_count = 0;
+    std::vector<uint64_t> spawn_keys;
+    for (uint32_t b = 0; b < buffer_count; b++) {
+        auto& buffer = buffers[b];
+        // 以 spawn 出来的对象为目标的命令不能排在 spawn 之前，排序键至少取 spawn 的排序键
+        // 同一个缓冲中这些命令一定在 spawn 之后记录，稳定排序后仍在 spawn 之后
+        spawn_keys.assign(buffer.spawn_names_.size(), 0);
+        for (uint32_t c = 0; c < buffer.commands_.size(); c++) {
+            const auto& command = buffer.commands_[c];
+            auto sort_key = command.sort_key;
+            if (command.type == EntityCommandBuffer::CommandType::eSpawn) {
+                spawn_keys[command.target.spawn_index] = sort_key;
+            } else if (command.target.spawn_index != CommandTarget::invalid_spawn_index && command.target.spawn_index < spawn_keys.size()) {
+                sort_key = std::max(sort_key, spawn_keys[command.target.spawn_index]);
+            }
+            entries.push_back({sort_key, b, c});
+        }
+        spawn_count += static_cast<uint32_t>(buffer.spawn_names_.size());
+    }
+    if (entries.empty()) {
+        return;
+    }
+    // 同一个排序键的命令来自同一个线程，稳定排序保持记录顺序
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.sort_key < rhs.sort_key; });
+    game_objects_.reserve(spawn_count);
+
+    std::vector<std::vector<GameObjectHandle>> spawned(buffer_count);
+    for (uint32_t b = 0; b < buffer_count; b++) {
+        spawned[b].resize(buffers[b].spawn_names_.size());
+    }
+    auto resolve = [&](uint32_t buffer, const CommandTarget& target) -> GameObject* {
+        if (target.spawn_index == CommandTarget::invalid_spawn_index) {
+            return game_objects_.get(target.handle);
+        }
+        auto handle = spawned[buffer][target.spawn_index];
+        if (handle.index == GameObjectHandle::invalid_index) {
+            WEN_CORE_ERROR("command targets spawn {} before it is played back.", target.spawn_index)
+            return nullptr;
+        }
+        return game_objects_.get(handle);
+    };
+
+    // 同一个目标连续的 addComponent 合并为一次插入，GameObject 只移动一次
+    GameObject* batch_target = nullptr;
+    std::vector<std::pair<Component*, ComponentTypeInfo>> batch;
+    auto flush_batch = [&]() {
+        if (!batch.empty()) {
+            batch_target->insertComponents(batch);
+            batch.clear();
+        }
+    };
+
+    for (const auto& entry : entries) {
+        auto& buffer = buffers[entry.buffer];
+        auto& command = buffer.commands_[entry.command];
+        auto* game_object = command.type == EntityCommandBuffer::CommandType::eSpawn ? nullptr : resolve(entry.buffer, command.target);
+        if (command.type != EntityCommandBuffer::CommandType::eAddComponent || game_object != batch_target) {
+            flush_batch();
+        }
+        switch (command.type) {
+            case EntityCommandBuffer::CommandType::eSpawn:
+                spawned[entry.buffer][command.target.spawn_index] = createGameObject(buffer.spawn_names_[command.target.spawn_index])->getHandle();
+                break;
+            case EntityCommandBuffer::CommandType::eDestroy:
+                if (game_object != nullptr) {
+                    game_objects_.destroy(game_object->getHandle());
+                }
+                break;
+            case EntityCommandBuffer::CommandType::eAddComponent:
+                if (game_object != nullptr) {
+                    batch_target = game_object;
+                    batch.push_back({command.component, command.info});
+                } else {
+                    delete command.component;
+                }
+                command.component = nullptr;
+                break;
+            case EntityCommandBuffer::CommandType::eRemoveComponent:
+                if (game_object != nullptr) {
+                    auto* component = game_object->storage_->getComponent(game_object->location_, command.info.uuid);
+                    if (component != nullptr) {
+                        game_object->removeComponent(component);
+                    }
+                }
+                break;
+        }
+    }
+    flush_batch();
+    if (spawned_game_objects != nullptr) {
+        for (const auto& handles : spawned) {
+            spawned_game_objects->insert(spawned_game_objects->end(), handles.begin(), handles.end());
+        }
+    }
+}
+
+void Scene::updateTransforms() {
+    transform_hierarchy_.update();
 }
 
 SceneManager::SceneManager() {
@@ -93,27 +252,125 @@ void SceneManager::loadScene(const std::string& name) {
     change_scene_ = iter->second;
 }
 
+Scene* SceneManager::load(const std::string& path) {
+    WEN_PROFILE_SCOPE("SceneManager::load")
+    Scene* scene = nullptr;
+    SceneSerializer::open(path, [&](DeserializeStream& stream) {
+        std::string name;
+        if (!SceneSerializer::readHeader(stream, name)) {
+            WEN_CORE_ERROR("'{}' is not a scene file of version {}.", path, SceneSerializer::version)
+            return false;
+        }
+        scene = createScene(name);
+        if (scene == nullptr) {
+            return false;
+        }
+        if (!global_context->scene_serializer->load(*scene, stream)) {
+            scenes_.erase(name);
+            if (active_scene_ == scene) {
+                active_scene_ = nullptr;
+            }
+            delete scene;
+            scene = nullptr;
+        }
+        return scene != nullptr;
+    });
+    return scene;
+}
+
 void SceneManager::start() {
     active_scene_->awake();
     active_scene_->start();
 }
 
-void SceneManager::fixedTick() {
-    active_scene_->fixedTick();
+void SceneManager::fixedTick(float dt) {
+    WEN_PROFILE_SCOPE("SceneManager::fixedTick")
+    active_scene_->fixedTick(dt);
+    active_scene_->playbackCommandBuffers();
+    active_scene_->flushDestroyedGameObjects();
 }
 
 void SceneManager::tick(float dt) {
+    WEN_PROFILE_SCOPE("SceneManager::tick")
     active_scene_->tick(dt);
     active_scene_->postTick(dt);
+    active_scene_->playbackCommandBuffers();
+    active_scene_->flushDestroyedGameObjects();
+    if (auto* world_partition = active_scene_->getWorldPartition(); world_partition != nullptr) {
+        world_partition->update(getStreamingFocus());
+    }
+    active_scene_->updateTransforms();
+    syncMeshInstances();
+    syncCameraControllers();
+    syncSpatialIndex();
+    active_scene_->getChangeTracker().clear();
+}
+
+void SceneManager::syncMeshInstances() {
+    auto* mesh_instance_pool = global_context->render_system->getRenderData()->getMeshInstancePool();
+    for (auto* game_object : active_scene_->getTransformHierarchy().getChangedGameObjects()) {
+        auto* mesh_component = game_object->queryComponent<MeshComponent>();
+        if (mesh_component != nullptr && mesh_component->mesh_instance_index != MeshInstancePool::invalid_index) {
+            mesh_instance_pool->mesh_instances[mesh_component->mesh_instance_index].model = game_object->queryComponent<TransformComponent>()->getWorldMatrix();
+            mesh_instance_pool->markDirty(mesh_component->mesh_instance_index);
+        }
+    }
+    for (auto handle : active_scene_->getChangeTracker().getChanged<MeshComponent>()) {
+        auto* game_object = active_scene_->getGameObject(handle);
+        auto* mesh_component = game_object == nullptr ? nullptr : game_object->queryComponent<MeshComponent>();
+        if (mesh_component != nullptr && mesh_component->mesh_instance_index != MeshInstancePool::invalid_index) {
+            mesh_instance_pool->mesh_instances[mesh_component->mesh_instance_index].mesh_id = mesh_component->mesh_id;
+            mesh_instance_pool->markDirty(mesh_component->mesh_instance_index);
+        }
+    }
+}
+
+void SceneManager::syncCameraControllers() {
+    for (auto handle : active_scene_->getChangeTracker().getChanged<TransformComponent>()) {
+        auto* game_object = active_scene_->getGameObject(handle);
+        auto* controller = game_object == nullptr ? nullptr : game_object->queryComponent<CameraControllerComponent>();
+        if (controller != nullptr) {
+            controller->onTransformChanged();
+        }
+    }
+}
+
+void SceneManager::syncSpatialIndex() {
+    auto& spatial_index = active_scene_->getSpatialIndex();
+    auto move = [&](GameObject* game_object) {
+        auto* mesh_component = game_object == nullptr ? nullptr : game_object->queryComponent<MeshComponent>();
+        if (mesh_component != nullptr && mesh_component->spatial_proxy != SpatialIndex::invalid_proxy) {
+            spatial_index.moveProxy(mesh_component->spatial_proxy, mesh_component->getWorldBounds());
+        }
+    };
+    for (auto* game_object : active_scene_->getTransformHierarchy().getChangedGameObjects()) {
+        move(game_object);
+    }
+    for (auto handle : active_scene_->getChangeTracker().getChanged<MeshComponent>()) {
+        move(active_scene_->getGameObject(handle));
+    }
+    // 所有变化一起处理，只有超出扩大包围盒的叶子才重新插入
+    spatial_index.refit();
+}
+
+glm::vec3 SceneManager::getStreamingFocus() const {
+    return glm::inverse(global_context->camera_system->getViewportCameraData().view)[3];
 }
 
 void SceneManager::swap() {
     if (change_scene_ == nullptr) {
         return;
     }
+    WEN_PROFILE_SCOPE("SceneManager::swap")
+    // 清空实例池后旧场景的下标指向别的对象的实例，销毁时不能再释放
+    if (active_scene_ != nullptr) {
+        active_scene_->each<MeshComponent>([](MeshComponent& mesh_component) { mesh_component.mesh_instance_index = MeshInstancePool::invalid_index; });
+    }
     active_scene_ = change_scene_;
     change_scene_ = nullptr;
     global_context->render_system->getRenderData()->clear();
+    // 新场景的实例可能在旧场景激活时创建，已经随实例池一起清空
+    active_scene_->each<MeshComponent>([](MeshComponent& mesh_component) { mesh_component.createMeshInstance(); });
     start();
 }
 
@@ -0,0 +1,445 @@
+#include "function/framework/scene_serializer.hpp"
+#include "function/framework/component/transform/transform_component.hpp"
+#include "engine/global_context.hpp"
+#include "core/serialize/mapped_stream.hpp"
+#include "core/serialize/compression.hpp"
+
+namespace wen {
+
+namespace {
+
+// 一组组件类型相同的对象，编号连续
+struct Group {
+    std::vector<uint32_t> types;
+    uint32_t first_object = 0;
+    uint32_t object_count = 0;
+    Archetype* archetype = nullptr;
+    std::vector<uint32_t> rows;
+};
+
+template <typename T>
+void writeBlock(SerializeStream& stream, const std::vector<T>& values) {
+    if (values.empty()) {
+        return;
+    }
+    stream.write(values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+bool readBlock(DeserializeStream& stream, std::vector<T>& values, size_t count) {
+    if (stream.getRemaining() < count * sizeof(T)) {
+        return false;
+    }
+    values.resize(count);
+    if (count > 0) {
+        stream.read(values.data(), count * sizeof(T));
+    }
+    return stream.good();
+}
+
+}  // namespace
+
+SceneSerializer::SceneSerializer() {}
+
+SceneSerializer::~SceneSerializer() {
+    serializers_.clear();
+}
+
+void SceneSerializer::addSerializer(ComponentSerializer&& serializer) {
+    auto uuid = serializer.info.uuid;
+    if (uuid >= serializers_.size()) {
+        serializers_.resize(uuid + 1);
+    }
+    if (serializers_[uuid].has_value()) {
+        WEN_CORE_ERROR("component {} has been registered for serialization.", serializer.class_name)
+        return;
+    }
+    serializers_[uuid] = std::move(serializer);
+}
+
+const ComponentSerializer* SceneSerializer::find(const std::string& class_name) const {
+    return find(global_context->component_type_uuid_system->get(class_name));
+}
+
+bool SceneSerializer::readHeader(DeserializeStream& stream, std::string& name) {
+    if (stream.getRemaining() < sizeof(uint32_t) * 2) {
+        return false;
+    }
+    uint32_t file_magic, file_version;
+    stream >> file_magic >> file_version;
+    if (file_magic != magic || file_version != version) {
+        return false;
+    }
+    stream >> name;
+    return stream.good();
+}
+
+// 依次写入文件头、组件类型表、对象名字、每组对象的组件数组、变换层次，边序列化边写入文件
+bool SceneSerializer::save(Scene& scene, const std::string& path, bool compress) const {
+    WEN_PROFILE_SCOPE("SceneSerializer::save")
+    auto transform_uuid = ComponentTypeUUIDSystem::get<TransformComponent>();
+
+    // 对象按 archetype 的行顺序编号，最后是没有组件的对象
+    std::vector<const ComponentSerializer*> types;
+    std::vector<uint32_t> type_indices;
+    std::vector<Group> groups;
+    std::vector<GameObject*> game_objects;
+    game_objects.reserve(scene.getGameObjectCount());
+    for (const auto& archetype : scene.getStorage().getArchetypes()) {
+        if (archetype->getAliveCount() == 0) {
+            continue;
+        }
+        auto& group = groups.emplace_back();
+        group.archetype = archetype.get();
+        group.first_object = static_cast<uint32_t>(game_objects.size());
+        for (auto uuid : archetype->getTypes()) {
+            auto* serializer = find(uuid);
+            if (serializer == nullptr) {
+                continue;
+            }
+            if (uuid >= type_indices.size()) {
+                type_indices.resize(uuid + 1, std::numeric_limits<uint32_t>::max());
+            }
+            if (type_indices[uuid] == std::numeric_limits<uint32_t>::max()) {
+                type_indices[uuid] = static_cast<uint32_t>(types.size());
+                types.push_back(serializer);
+            }
+            group.types.push_back(uuid);
+        }
+        // 其他组件的 onCreate 可能依赖 TransformComponent，加载时最先创建
+        std::stable_partition(group.types.begin(), group.types.end(), [transform_uuid](auto uuid) { return uuid == transform_uuid; });
+        for (uint32_t row = 0; row < archetype->getRowCount(); row++) {
+            if (auto* game_object = archetype->getGameObject(row); game_object != nullptr) {
+                game_objects.push_back(game_object);
+                group.rows.push_back(row);
+            }
+        }
+        group.object_count = static_cast<uint32_t>(group.rows.size());
+    }
+    auto& empty_group = groups.emplace_back();
+    empty_group.first_object = static_cast<uint32_t>(game_objects.size());
+    scene.forEachGameObject([&](GameObject* game_object) {
+        if (game_object->location_.archetype == nullptr) {
+            game_objects.push_back(game_object);
+        }
+    });
+    empty_group.object_count = static_cast<uint32_t>(game_objects.size()) - empty_group.first_object;
+
+    std::vector<uint32_t> object_indices;
+    for (uint32_t i = 0; i < game_objects.size(); i++) {
+        auto index = game_objects[i]->getHandle().index;
+        if (index >= object_indices.size()) {
+            object_indices.resize(index + 1);
+        }
+        object_indices[index] = i;
+    }
+
+    FileSink file_sink(path);
+    if (!file_sink.isOpen()) {
+        return false;
+    }
+    // 压缩帧的帧头需要解压后的总大小，压缩时先写入内存
+    std::optional<SerializeStream> optional_stream;
+    if (compress) {
+        optional_stream.emplace();
+    } else {
+        optional_stream.emplace(file_sink);
+    }
+    auto& stream = *optional_stream;
+    stream << magic << version << scene.getName();
+
+    stream << static_cast<uint32_t>(types.size());
+    for (auto* type : types) {
+        stream << type->class_name << type->packed_size;
+    }
+
+    // 名字连续存放，另存每个名字的长度
+    std::string names;
+    std::vector<uint32_t> name_lengths;
+    name_lengths.reserve(game_objects.size());
+    for (auto* game_object : game_objects) {
+        names += game_object->name_;
+        name_lengths.push_back(static_cast<uint32_t>(game_object->name_.size()));
+    }
+    stream << static_cast<uint32_t>(game_objects.size());
+    writeBlock(stream, name_lengths);
+    stream << names;
+
+    stream << static_cast<uint32_t>(groups.size());
+    std::vector<uint8_t> packed;
+    // 不能打包的组件先写入 section，加载前根据字节数检查数据是否完整
+    SerializeStream section;
+    for (const auto& group : groups) {
+        stream << static_cast<uint32_t>(group.types.size());
+        for (auto type : group.types) {
+            stream << type_indices[type];
+        }
+        stream << group.object_count;
+        for (auto type : group.types) {
+            auto* serializer = types[type_indices[type]];
+            auto column = group.archetype->findColumn(type);
+            if (serializer->packed_size != 0) {
+                packed.resize(static_cast<size_t>(serializer->packed_size) * group.object_count);
+                for (uint32_t i = 0; i < group.object_count; i++) {
+                    serializer->pack(packed.data() + static_cast<size_t>(i) * serializer->packed_size, group.archetype->getComponent(column, group.rows[i]));
+                }
+                writeBlock(stream, packed);
+            } else {
+                section.clear();
+                for (uint32_t i = 0; i < group.object_count; i++) {
+                    serializer->serialize(section, group.archetype->getComponent(column, group.rows[i]));
+                }
+                auto data = section.getData();
+                stream << static_cast<uint64_t>(data.size());
+                stream.write(data.data(), data.size());
+            }
+        }
+    }
+
+    // 变换层次，(子节点, 父节点) 的对象编号
+    std::vector<uint32_t> parents;
+    if (find(transform_uuid) != nullptr) {
+        for (uint32_t i = 0; i < game_objects.size(); i++) {
+            auto* transform_component = game_objects[i]->queryComponent<TransformComponent>();
+            auto* parent = transform_component == nullptr ? nullptr : transform_component->getParent();
+            if (parent != nullptr) {
+                parents.push_back(i);
+                parents.push_back(object_indices[parent->getGameObject()->getHandle().index]);
+            }
+        }
+    }
+    stream << static_cast<uint32_t>(parents.size() / 2);
+    writeBlock(stream, parents);
+
+    bool written = stream.flush();
+    if (written && compress) {
+        // 压缩在工作线程上按块并行进行
+        auto data = stream.getData();
+        CompressSink compress_sink(file_sink, data.size(), CompressedFrame::default_block_size, global_context->job_system.getInstance());
+        written = compress_sink.write(data.data(), data.size()) && compress_sink.finish();
+    }
+    if (!written) {
+        WEN_CORE_ERROR("Could not write scene file '{}'", path)
+        return false;
+    }
+    return true;
+}
+
+bool SceneSerializer::open(const std::string& path, const std::function<bool(DeserializeStream&)>& fn) {
+    // 只读入实际访问到的页
+    MappedDeserializeStream stream(path);
+    if (!stream.isOpen()) {
+        return false;
+    }
+    auto data = stream.getMappedData();
+    if (!CompressedFrame::isCompressed(data)) {
+        return fn(stream);
+    }
+    // 解压后的数据不能原地访问，按批读入映射的压缩块并在工作线程上并行解压
+    MemorySource source(data);
+    DecompressSource decompress_source(source, global_context->job_system.getInstance());
+    DeserializeStream decompress_stream(decompress_source);
+    return fn(decompress_stream);
+}
+
+bool SceneSerializer::load(Scene& scene, const std::string& path) const {
+    return open(path, [&](DeserializeStream& stream) {
+        std::string name;
+        if (!readHeader(stream, name)) {
+            WEN_CORE_ERROR("'{}' is not a scene file of version {}.", path, version)
+            return false;
+        }
+        return load(scene, stream);
+    });
+}
+
+bool SceneSerializer::load(Scene& scene, DeserializeStream& stream) const {
+    WEN_PROFILE_SCOPE("SceneSerializer::load")
+    uint32_t type_count;
+    stream >> type_count;
+    if (!stream.good() || type_count > stream.getRemaining()) {
+        WEN_CORE_ERROR("failed to load scene: scene file is truncated.")
+        return false;
+    }
+    std::vector<const ComponentSerializer*> types(type_count);
+    std::vector<const ClassDescriptor*> descriptors(type_count);
+    for (uint32_t i = 0; i < type_count; i++) {
+        std::string class_name;
+        uint32_t packed_size;
+        stream >> class_name >> packed_size;
+        types[i] = find(class_name);
+        if (types[i] == nullptr) {
+            WEN_CORE_ERROR("failed to load scene: component {} is not registered for serialization.", class_name)
+            return false;
+        }
+        if (types[i]->packed_size != packed_size) {
+            WEN_CORE_ERROR("failed to load scene: serializable members of component {} have changed.", class_name)
+            return false;
+        }
+        descriptors[i] = global_context->reflect_system->findClass(class_name);
+        if (descriptors[i] == nullptr) {
+            WEN_CORE_ERROR("failed to load scene: component {} is not reflected.", class_name)
+            return false;
+        }
+    }
+
+    uint32_t object_count;
+    stream >> object_count;
+    std::vector<uint32_t> name_lengths;
+    if (!readBlock(stream, name_lengths, object_count)) {
+        WEN_CORE_ERROR("failed to load scene: scene file is truncated.")
+        return false;
+    }
+    std::string names;
+    stream >> names;
+
+    std::vector<GameObject*> game_objects;
+    // 已经构造的组件还没有 onCreate，不调用 onDestroy
+    // 先取走位置再移除对象，析构时看不到组件，对象移除之后才析构组件，不会访问已经释放的存储
+    auto fail = [&](const char* reason) {
+        WEN_CORE_ERROR("failed to load scene: {}", reason)
+        for (auto* game_object : game_objects) {
+            auto location = std::exchange(game_object->location_, EntityLocation{});
+            scene.removeGameObject(game_object);
+            scene.getStorage().erase(location);
+        }
+        return false;
+    };
+    // 名字长度来自文件，创建对象之前检查是否越界
+    uint64_t names_size = 0;
+    for (auto name_length : name_lengths) {
+        names_size += name_length;
+    }
+    if (!stream.good() || names_size > names.size()) {
+        return fail("scene file is corrupted.");
+    }
+
+    // 一次分配所有对象
+    game_objects.reserve(object_count);
+    scene.reserveGameObjects(object_count);
+    size_t name_offset = 0;
+    for (uint32_t i = 0; i < object_count; i++) {
+        game_objects.push_back(scene.createGameObject(names.substr(name_offset, name_lengths[i])));
+        name_offset += name_lengths[i];
+    }
+
+    uint32_t group_count;
+    stream >> group_count;
+    std::vector<Group> groups(group_count);
+    std::vector<EntityLocation> locations;
+    std::vector<ComponentTypeInfo> infos;
+    std::vector<uint8_t> packed;
+    uint32_t first_object = 0;
+    for (auto& group : groups) {
+        uint32_t group_type_count;
+        stream >> group_type_count;
+        group.types.resize(group_type_count);
+        infos.clear();
+        for (auto& type : group.types) {
+            stream >> type;
+            if (type >= type_count) {
+                return fail("scene file is corrupted.");
+            }
+            infos.push_back(types[type]->info);
+        }
+        stream >> group.object_count;
+        group.first_object = first_object;
+        first_object += group.object_count;
+        if (first_object > object_count) {
+            return fail("scene file is corrupted.");
+        }
+        if (group.types.empty() || group.object_count == 0) {
+            continue;
+        }
+
+        // 先构造整组的组件，存储在任何时候都保持有效
+        auto* objects = &game_objects[group.first_object];
+        locations.resize(group.object_count);
+        group.archetype = scene.getStorage().allocateRows(infos, objects, group.object_count, locations.data());
+        group.rows.resize(group.object_count);
+        for (uint32_t i = 0; i < group.object_count; i++) {
+            objects[i]->location_ = locations[i];
+            group.rows[i] = locations[i].row;
+        }
+        for (auto type : group.types) {
+            auto* serializer = types[type];
+            auto column = group.archetype->findColumn(serializer->info.uuid);
+            for (uint32_t i = 0; i < group.object_count; i++) {
+                void* component = group.archetype->getComponent(column, group.rows[i]);
+                serializer->construct(component);
+                objects[i]->bindComponent(serializer->info.to_component(component), serializer->info.uuid, descriptors[type]);
+            }
+        }
+
+        for (auto type : group.types) {
+            auto* serializer = types[type];
+            auto column = group.archetype->findColumn(serializer->info.uuid);
+            if (serializer->packed_size != 0) {
+                // 数据已经在连续的内存中时直接解包，映射的文件不需要复制
+                auto size = static_cast<size_t>(serializer->packed_size) * group.object_count;
+                auto* src = stream.view(size);
+                if (src == nullptr) {
+                    if (!readBlock(stream, packed, size)) {
+                        return fail("scene file is truncated.");
+                    }
+                    src = packed.data();
+                }
+                for (uint32_t i = 0; i < group.object_count; i++) {
+                    serializer->unpack(src + static_cast<size_t>(i) * serializer->packed_size, group.archetype->getComponent(column, group.rows[i]));
+                }
+            } else {
+                uint64_t size;
+                stream >> size;
+                if (stream.getRemaining() < size) {
+                    return fail("scene file is truncated.");
+                }
+                auto end = stream.getPosition() + size;
+                for (uint32_t i = 0; i < group.object_count; i++) {
+                    serializer->deserialize(stream, group.archetype->getComponent(column, group.rows[i]));
+                }
+                if (!stream.good() || stream.getPosition() != end) {
+                    return fail("scene file is corrupted.");
+                }
+            }
+        }
+    }
+
+    uint32_t parent_count;
+    stream >> parent_count;
+    std::vector<uint32_t> parents;
+    if (!readBlock(stream, parents, static_cast<size_t>(parent_count) * 2)) {
+        return fail("scene file is truncated.");
+    }
+
+    // 所有组件都读入之后按文件中的类型顺序调用 onCreate
+    auto transform_uuid = ComponentTypeUUIDSystem::get<TransformComponent>();
+    uint32_t transform_count = 0;
+    for (const auto& group : groups) {
+        for (auto type : group.types) {
+            transform_count += types[type]->info.uuid == transform_uuid ? group.object_count : 0;
+        }
+    }
+    scene.getTransformHierarchy().reserve(transform_count);
+    for (const auto& group : groups) {
+        for (uint32_t i = 0; i < group.object_count && !group.types.empty(); i++) {
+            for (auto type : group.types) {
+                auto column = group.archetype->findColumn(types[type]->info.uuid);
+                group.archetype->getComponentBase(column, group.rows[i])->onCreate();
+            }
+        }
+    }
+    for (uint32_t i = 0; i < parent_count; i++) {
+        auto child = parents[i * 2], parent = parents[i * 2 + 1];
+        if (child >= object_count || parent >= object_count) {
+            continue;
+        }
+        auto* child_transform = game_objects[child]->queryComponent<TransformComponent>();
+        auto* parent_transform = game_objects[parent]->queryComponent<TransformComponent>();
+        if (child_transform != nullptr && parent_transform != nullptr) {
+            child_transform->setParent(parent_transform);
+        }
+    }
+    return true;
+}
+
+}  // namespace wen
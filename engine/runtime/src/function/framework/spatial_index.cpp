@@ -0,0 +1,302 @@
+#include "function/framework/spatial_index.hpp"
+
+namespace wen {
+
+AABB AABB::transform(const glm::mat4& matrix) const {
+    // 每一列分别取最小和最大的贡献，等价于变换八个角点
+    glm::vec3 translation = matrix[3];
+    AABB result{translation, translation};
+    for (int i = 0; i < 3; i++) {
+        glm::vec3 axis = matrix[i];
+        auto a = axis * min[i];
+        auto b = axis * max[i];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+    return result;
+}
+
+bool Ray::intersect(const AABB& aabb, float max_distance, float& t) const {
+    float t_min = 0.0f;
+    float t_max = max_distance;
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(direction[i]) < std::numeric_limits<float>::epsilon()) {
+            if (origin[i] < aabb.min[i] || origin[i] > aabb.max[i]) {
+                return false;
+            }
+            continue;
+        }
+        float inverse = 1.0f / direction[i];
+        float t0 = (aabb.min[i] - origin[i]) * inverse;
+        float t1 = (aabb.max[i] - origin[i]) * inverse;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        t_min = std::max(t_min, t0);
+        t_max = std::min(t_max, t1);
+        if (t_min > t_max) {
+            return false;
+        }
+    }
+    t = t_min;
+    return true;
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& view_projection) {
+    auto row = [&](int i) { return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]); };
+    auto x = row(0), y = row(1), z = row(2), w = row(3);
+    Frustum frustum{{w + x, w - x, w + y, w - y, w + z, w - z}};
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::intersects(const AABB& aabb) const {
+    for (const auto& plane : planes) {
+        // 取法线方向上最远的角点
+        glm::vec3 normal = plane;
+        auto corner = glm::mix(aabb.min, aabb.max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+        if (glm::dot(normal, corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SpatialIndex::ProxyID SpatialIndex::createProxy(const AABB& bounds, GameObjectHandle handle) {
+    auto leaf = allocateNode();
+    auto& node = nodes_[leaf];
+    node.bounds = fatten(bounds);
+    node.height = 0;
+    node.handle = handle;
+    bounds_[leaf] = bounds;
+    moved_[leaf] = false;
+    insertLeaf(leaf);
+    proxy_count_++;
+    return leaf;
+}
+
+void SpatialIndex::destroyProxy(ProxyID proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxy_count_--;
+}
+
+void SpatialIndex::moveProxy(ProxyID proxy, const AABB& bounds) {
+    bounds_[proxy] = bounds;
+    if (!moved_[proxy]) {
+        moved_[proxy] = true;
+        moved_proxies_.push_back(proxy);
+    }
+}
+
+void SpatialIndex::refit() {
+    for (auto proxy : moved_proxies_) {
+        // 记录之后已经销毁
+        if (!moved_[proxy]) {
+            continue;
+        }
+        moved_[proxy] = false;
+        if (nodes_[proxy].bounds.contains(bounds_[proxy])) {
+            continue;
+        }
+        removeLeaf(proxy);
+        nodes_[proxy].bounds = fatten(bounds_[proxy]);
+        insertLeaf(proxy);
+    }
+    moved_proxies_.clear();
+}
+
+void SpatialIndex::clear() {
+    nodes_.clear();
+    bounds_.clear();
+    moved_.clear();
+    moved_proxies_.clear();
+    root_ = invalid_node;
+    free_head_ = invalid_node;
+    proxy_count_ = 0;
+}
+
+void SpatialIndex::queryNearest(const glm::vec3& point, uint32_t k, std::vector<NearestResult>& results) const {
+    if (root_ == invalid_node || k == 0) {
+        return;
+    }
+    // 按距离从小到大取出，内部节点使用扩大的包围盒，叶子使用精确包围盒
+    // 节点的距离不大于其中任何叶子的距离，叶子被取出时一定是剩余中最近的
+    struct Entry {
+        float distance2;
+        uint32_t index;
+        bool exact;
+
+        bool operator<(const Entry& rhs) const { return distance2 > rhs.distance2; }
+    };
+    std::vector<Entry> heap;
+    heap.push_back({nodes_[root_].bounds.distance2(point), root_, false});
+    uint32_t found = 0;
+    while (!heap.empty() && found < k) {
+        std::pop_heap(heap.begin(), heap.end());
+        auto entry = heap.back();
+        heap.pop_back();
+        const auto& node = nodes_[entry.index];
+        if (entry.exact) {
+            results.push_back({node.handle, std::sqrt(entry.distance2)});
+            found++;
+            continue;
+        }
+        if (node.isLeaf()) {
+            heap.push_back({bounds_[entry.index].distance2(point), entry.index, true});
+            std::push_heap(heap.begin(), heap.end());
+            continue;
+        }
+        for (auto child : node.children) {
+            heap.push_back({nodes_[child].bounds.distance2(point), child, false});
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+}
+
+uint32_t SpatialIndex::allocateNode() {
+    uint32_t index = free_head_;
+    if (index != invalid_node) {
+        free_head_ = nodes_[index].parent;
+        nodes_[index] = Node{};
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        bounds_.emplace_back();
+        moved_.push_back(false);
+    }
+    return index;
+}
+
+void SpatialIndex::freeNode(uint32_t index) {
+    nodes_[index] = Node{};
+    nodes_[index].parent = free_head_;
+    moved_[index] = false;
+    free_head_ = index;
+}
+
+void SpatialIndex::insertLeaf(uint32_t leaf) {
+    if (root_ == invalid_node) {
+        root_ = leaf;
+        nodes_[leaf].parent = invalid_node;
+        return;
+    }
+
+    // 从根向下选择增加表面积最小的兄弟节点
+    auto leaf_bounds = nodes_[leaf].bounds;
+    uint32_t index = root_;
+    while (!nodes_[index].isLeaf()) {
+        const auto& node = nodes_[index];
+        float area = node.bounds.getHalfArea();
+        float combined_area = AABB::merge(node.bounds, leaf_bounds).getHalfArea();
+        // 在这里建立新的父节点的代价
+        float cost = 2.0f * combined_area;
+        // 继续向下时这个节点增大的代价
+        float inheritance_cost = 2.0f * (combined_area - area);
+        float child_costs[2];
+        for (int i = 0; i < 2; i++) {
+            const auto& child = nodes_[node.children[i]];
+            float child_area = AABB::merge(child.bounds, leaf_bounds).getHalfArea();
+            child_costs[i] = (child.isLeaf() ? child_area : child_area - child.bounds.getHalfArea()) + inheritance_cost;
+        }
+        if (cost < child_costs[0] && cost < child_costs[1]) {
+            break;
+        }
+        index = child_costs[0] < child_costs[1] ? node.children[0] : node.children[1];
+    }
+
+    uint32_t sibling = index;
+    uint32_t old_parent = nodes_[sibling].parent;
+    uint32_t new_parent = allocateNode();
+    auto& parent = nodes_[new_parent];
+    parent.parent = old_parent;
+    parent.bounds = AABB::merge(leaf_bounds, nodes_[sibling].bounds);
+    parent.height = nodes_[sibling].height + 1;
+    parent.children[0] = sibling;
+    parent.children[1] = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+    if (old_parent == invalid_node) {
+        root_ = new_parent;
+    } else {
+        auto& children = nodes_[old_parent].children;
+        children[children[0] == sibling ? 0 : 1] = new_parent;
+    }
+    fixUpwards(nodes_[leaf].parent);
+}
+
+void SpatialIndex::removeLeaf(uint32_t leaf) {
+    if (leaf == root_) {
+        root_ = invalid_node;
+        return;
+    }
+    uint32_t parent = nodes_[leaf].parent;
+    uint32_t grand_parent = nodes_[parent].parent;
+    uint32_t sibling = nodes_[parent].children[0] == leaf ? nodes_[parent].children[1] : nodes_[parent].children[0];
+    freeNode(parent);
+    if (grand_parent == invalid_node) {
+        root_ = sibling;
+        nodes_[sibling].parent = invalid_node;
+        return;
+    }
+    auto& children = nodes_[grand_parent].children;
+    children[children[0] == parent ? 0 : 1] = sibling;
+    nodes_[sibling].parent = grand_parent;
+    fixUpwards(grand_parent);
+}
+
+void SpatialIndex::fixUpwards(uint32_t index) {
+    while (index != invalid_node) {
+        index = balance(index);
+        auto& node = nodes_[index];
+        const auto& child0 = nodes_[node.children[0]];
+        const auto& child1 = nodes_[node.children[1]];
+        node.height = 1 + std::max(child0.height, child1.height);
+        node.bounds = AABB::merge(child0.bounds, child1.bounds);
+        index = node.parent;
+    }
+}
+
+uint32_t SpatialIndex::balance(uint32_t a) {
+    if (nodes_[a].isLeaf() || nodes_[a].height < 2) {
+        return a;
+    }
+    uint32_t b = nodes_[a].children[0];
+    uint32_t c = nodes_[a].children[1];
+    int32_t difference = nodes_[c].height - nodes_[b].height;
+    if (difference >= -1 && difference <= 1) {
+        return a;
+    }
+
+    // 较高的子节点 high 上移成为 a 的父节点，high 较矮的子节点替换 high 在 a 中的位置
+    uint32_t high = difference > 1 ? c : b;
+    uint32_t low = difference > 1 ? b : c;
+    uint32_t f = nodes_[high].children[0];
+    uint32_t g = nodes_[high].children[1];
+
+    nodes_[high].children[0] = a;
+    nodes_[high].parent = nodes_[a].parent;
+    nodes_[a].parent = high;
+    if (nodes_[high].parent == invalid_node) {
+        root_ = high;
+    } else {
+        auto& children = nodes_[nodes_[high].parent].children;
+        children[children[0] == a ? 0 : 1] = high;
+    }
+
+    uint32_t keep = nodes_[f].height > nodes_[g].height ? f : g;
+    uint32_t move = keep == f ? g : f;
+    nodes_[high].children[1] = keep;
+    nodes_[a].children[difference > 1 ? 1 : 0] = move;
+    nodes_[move].parent = a;
+
+    nodes_[a].bounds = AABB::merge(nodes_[low].bounds, nodes_[move].bounds);
+    nodes_[a].height = 1 + std::max(nodes_[low].height, nodes_[move].height);
+    nodes_[high].bounds = AABB::merge(nodes_[a].bounds, nodes_[keep].bounds);
+    nodes_[high].height = 1 + std::max(nodes_[a].height, nodes_[keep].height);
+    return high;
+}
+
+}  // namespace wen
@@ -0,0 +1,144 @@
+#include "function/framework/system.hpp"
+#include "engine/global_context.hpp"
+
+namespace wen {
+
+static bool containsAny(const std::vector<ComponentTypeUUID>& lhs, const std::vector<ComponentTypeUUID>& rhs) {
+    for (auto uuid : lhs) {
+        if (std::find(rhs.begin(), rhs.end(), uuid) != rhs.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SystemAccess::conflicts(const SystemAccess& rhs) const {
+    if (exclusive_ || rhs.exclusive_) {
+        return true;
+    }
+    return containsAny(writes_, rhs.writes_) || containsAny(writes_, rhs.reads_) || containsAny(reads_, rhs.writes_);
+}
+
+LegacyComponentSystem::LegacyComponentSystem(SystemPhase phase) : System("LegacyComponentSystem"), phase_(phase) {}
+
+void LegacyComponentSystem::run(Scene& scene, float dt) {
+    auto& storage = scene.getStorage();
+    switch (phase_) {
+        case SystemPhase::eFixedTick:
+            storage.forEachComponent([](Component* component) { component->onFixedTick(); });
+            break;
+        case SystemPhase::eTick:
+            storage.forEachComponent([dt](Component* component) { component->onTick(dt); });
+            break;
+        case SystemPhase::ePostTick:
+            storage.forEachComponent([dt](Component* component) { component->onPostTick(dt); });
+            break;
+    }
+}
+
+System* SystemScheduler::addSystem(SystemPhase phase, std::unique_ptr<System> system) {
+    auto& graph = phases_[static_cast<size_t>(phase)];
+    SystemNode node{std::move(system), {}};
+    node.system->profile_name_ = ProfileSystem::internName(node.system->getName());
+    node.system->setupAccess(node.access);
+    auto* result = node.system.get();
+    graph.nodes.push_back(std::move(node));
+    graph.dirty = true;
+    return result;
+}
+
+void SystemScheduler::removeSystem(System* system) {
+    for (auto& graph : phases_) {
+        auto iter = std::find_if(graph.nodes.begin(), graph.nodes.end(), [system](const auto& node) { return node.system.get() == system; });
+        if (iter != graph.nodes.end()) {
+            graph.nodes.erase(iter);
+            graph.dirty = true;
+            return;
+        }
+    }
+    WEN_CORE_ERROR("system {} is not registered.", system->getName())
+}
+
+void SystemScheduler::buildGraph(PhaseGraph& graph) {
+    auto count = static_cast<uint32_t>(graph.nodes.size());
+    graph.successors.assign(count, {});
+    graph.predecessor_counts.assign(count, 0);
+    // 独占系统单独运行，只需要在两个独占系统之间建立依赖
+    uint32_t segment_begin = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (graph.nodes[i].access.isExclusive()) {
+            segment_begin = i + 1;
+            continue;
+        }
+        for (uint32_t j = segment_begin; j < i; j++) {
+            if (graph.nodes[j].access.conflicts(graph.nodes[i].access)) {
+                graph.successors[j].push_back(i);
+                graph.predecessor_counts[i]++;
+            }
+        }
+    }
+    graph.dirty = false;
+}
+
+void SystemScheduler::run(SystemPhase phase, Scene& scene, float dt) {
+    auto& graph = phases_[static_cast<size_t>(phase)];
+    if (graph.dirty) {
+        buildGraph(graph);
+    }
+    auto count = static_cast<uint32_t>(graph.nodes.size());
+    uint32_t run_index = run_count_++;
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (graph.nodes[i].access.isExclusive()) {
+            runParallel(graph, begin, i, run_index, scene, dt);
+            auto* system = graph.nodes[i].system.get();
+            CommandSortKey::Scope scope(CommandSortKey::makeSystemKey(run_index, i));
+            WEN_PROFILE_SCOPE(system->getProfileName())
+            system->run(scene, dt);
+            begin = i + 1;
+        }
+    }
+    runParallel(graph, begin, count, run_index, scene, dt);
+}
+
+void SystemScheduler::runParallel(PhaseGraph& graph, uint32_t begin, uint32_t end, uint32_t run_index, Scene& scene, float dt) {
+    if (begin >= end) {
+        return;
+    }
+    auto run_system = [&](uint32_t index) {
+        auto* system = graph.nodes[index].system.get();
+        CommandSortKey::Scope scope(CommandSortKey::makeSystemKey(run_index, index));
+        WEN_PROFILE_SCOPE(system->getProfileName())
+        system->run(scene, dt);
+    };
+    if (end - begin == 1) {
+        run_system(begin);
+        return;
+    }
+
+    auto& job_system = *global_context->job_system;
+    auto remaining = std::make_unique<std::atomic<uint32_t>[]>(end - begin);
+    for (uint32_t i = begin; i < end; i++) {
+        remaining[i - begin].store(graph.predecessor_counts[i], std::memory_order_relaxed);
+    }
+    auto handle = std::make_shared<JobCounter>();
+    // 系统完成后减少后继的计数，归零的后继在当前工作线程上继续调度
+    std::function<void(uint32_t)> launch = [&](uint32_t index) {
+        job_system.schedule([&, index]() {
+            run_system(index);
+            for (auto successor : graph.successors[index]) {
+                if (remaining[successor - begin].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    launch(successor);
+                }
+            }
+        }, handle);
+    };
+    for (uint32_t i = begin; i < end; i++) {
+        if (graph.predecessor_counts[i] == 0) {
+            launch(i);
+        }
+    }
+    job_system.wait(handle);
+}
+
+}  // namespace wen
@@ -0,0 +1,229 @@
+#include "function/framework/transform_hierarchy.hpp"
+#include "engine/global_context.hpp"
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/euler_angles.hpp>
+
+namespace wen {
+
+// 每个任务处理的节点数
+constexpr uint32_t update_grain_size = 1024;
+
+TransformHierarchy::NodeID TransformHierarchy::createNode(GameObject* owner, const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale) {
+    NodeID node;
+    if (!free_nodes_.empty()) {
+        node = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        node = static_cast<NodeID>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    // 新节点是根节点，追加在末尾不破坏父节点在前的顺序，不需要重新排序
+    uint32_t position = static_cast<uint32_t>(node_ids_.size());
+    nodes_[node] = {owner, invalid_node, position, 0};
+    node_ids_.push_back(node);
+    parents_.push_back(invalid_position);
+    locations_.push_back(location);
+    rotations_.push_back(rotation);
+    scales_.push_back(scale);
+    world_matrices_.emplace_back(1.0f);
+    dirty_.push_back(0);
+    markDirty(position);
+    return node;
+}
+
+void TransformHierarchy::reserve(uint32_t count) {
+    nodes_.reserve(nodes_.size() + count);
+    auto size = node_ids_.size() + count;
+    node_ids_.reserve(size);
+    parents_.reserve(size);
+    locations_.reserve(size);
+    rotations_.reserve(size);
+    scales_.reserve(size);
+    world_matrices_.reserve(size);
+    dirty_.reserve(size);
+}
+
+void TransformHierarchy::destroyNode(NodeID node) {
+    auto& data = nodes_[node];
+    if (data.child_count > 0) {
+        for (NodeID child = 0; child < nodes_.size(); child++) {
+            if (nodes_[child].owner != nullptr && nodes_[child].parent == node) {
+                nodes_[child].parent = invalid_node;
+                markDirty(nodes_[child].position);
+            }
+        }
+        order_dirty_ = true;
+    }
+    if (data.parent != invalid_node) {
+        nodes_[data.parent].child_count--;
+    }
+    // 留下空位，下一次 rebuild 时移除
+    node_ids_[data.position] = invalid_node;
+    parents_[data.position] = invalid_position;
+    dirty_[data.position] = 0;
+    hole_count_++;
+    data = {};
+    free_nodes_.push_back(node);
+}
+
+bool TransformHierarchy::setParent(NodeID node, NodeID parent) {
+    auto& data = nodes_[node];
+    if (data.parent == parent) {
+        return true;
+    }
+    for (NodeID ancestor = parent; ancestor != invalid_node; ancestor = nodes_[ancestor].parent) {
+        if (ancestor == node) {
+            return false;
+        }
+    }
+    if (data.parent != invalid_node) {
+        nodes_[data.parent].child_count--;
+    }
+    if (parent != invalid_node) {
+        nodes_[parent].child_count++;
+    }
+    data.parent = parent;
+    order_dirty_ = true;
+    markDirty(data.position);
+    return true;
+}
+
+void TransformHierarchy::setLocalTransform(NodeID node, const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale) {
+    uint32_t position = nodes_[node].position;
+    locations_[position] = location;
+    rotations_[position] = rotation;
+    scales_[position] = scale;
+    markDirty(position);
+}
+
+void TransformHierarchy::markDirty(uint32_t position) {
+    dirty_[position] = 1;
+    has_dirty_ = true;
+}
+
+void TransformHierarchy::update() {
+    WEN_PROFILE_SCOPE("TransformHierarchy::update")
+    changed_game_objects_.clear();
+    if (order_dirty_ || hole_count_ > node_ids_.size() / 2) {
+        rebuild();
+    }
+    if (!has_dirty_) {
+        return;
+    }
+    has_dirty_ = false;
+
+    auto count = static_cast<uint32_t>(node_ids_.size());
+    // 父节点在前，一次线性遍历就能把脏标记传播到整棵子树
+    for (uint32_t position = 0; position < count; position++) {
+        uint32_t parent = parents_[position];
+        if (parent != invalid_position && dirty_[parent]) {
+            dirty_[position] = 1;
+        }
+    }
+
+    // 同一层的节点互不依赖，逐层并行计算；末尾新建的根节点作为额外的一层
+    auto update_level = [this](uint32_t begin, uint32_t end) {
+        global_context->job_system->parallelFor(begin, end, update_grain_size, [this](uint32_t batch_begin, uint32_t batch_end) {
+            for (uint32_t position = batch_begin; position < batch_end; position++) {
+                if (!dirty_[position]) {
+                    continue;
+                }
+                auto local = composeMatrix(locations_[position], rotations_[position], scales_[position]);
+                uint32_t parent = parents_[position];
+                world_matrices_[position] = parent == invalid_position ? local : world_matrices_[parent] * local;
+            }
+        });
+    };
+    for (size_t level = 0; level + 1 < depth_offsets_.size(); level++) {
+        update_level(depth_offsets_[level], depth_offsets_[level + 1]);
+    }
+    update_level(depth_offsets_.empty() ? 0 : depth_offsets_.back(), count);
+
+    for (uint32_t position = 0; position < count; position++) {
+        if (dirty_[position]) {
+            dirty_[position] = 0;
+            changed_game_objects_.push_back(nodes_[node_ids_[position]].owner);
+        }
+    }
+}
+
+void TransformHierarchy::rebuild() {
+    // 通过节点的父子关系计算深度，rebuild 之前数组中的顺序可能已经失效
+    std::vector<uint32_t> depths(nodes_.size(), invalid_position);
+    std::vector<NodeID> chain;
+    uint32_t max_depth = 0;
+    for (NodeID node : node_ids_) {
+        if (node == invalid_node) {
+            continue;
+        }
+        NodeID current = node;
+        while (current != invalid_node && depths[current] == invalid_position) {
+            chain.push_back(current);
+            current = nodes_[current].parent;
+        }
+        uint32_t depth = current == invalid_node ? 0 : depths[current] + 1;
+        while (!chain.empty()) {
+            depths[chain.back()] = depth++;
+            chain.pop_back();
+        }
+        max_depth = std::max(max_depth, depths[node]);
+    }
+
+    depth_offsets_.assign(max_depth + 2, 0);
+    for (NodeID node : node_ids_) {
+        if (node != invalid_node) {
+            depth_offsets_[depths[node] + 1]++;
+        }
+    }
+    for (uint32_t level = 1; level < depth_offsets_.size(); level++) {
+        depth_offsets_[level] += depth_offsets_[level - 1];
+    }
+
+    auto count = depth_offsets_.back();
+    std::vector<NodeID> node_ids(count);
+    std::vector<glm::vec3> locations(count);
+    std::vector<glm::vec3> rotations(count);
+    std::vector<glm::vec3> scales(count);
+    std::vector<glm::mat4> world_matrices(count);
+    std::vector<uint8_t> dirty(count);
+    std::vector<uint32_t> offsets(depth_offsets_.begin(), depth_offsets_.end() - 1);
+    for (uint32_t position = 0; position < node_ids_.size(); position++) {
+        NodeID node = node_ids_[position];
+        if (node == invalid_node) {
+            continue;
+        }
+        uint32_t target = offsets[depths[node]]++;
+        node_ids[target] = node;
+        locations[target] = locations_[position];
+        rotations[target] = rotations_[position];
+        scales[target] = scales_[position];
+        world_matrices[target] = world_matrices_[position];
+        dirty[target] = dirty_[position];
+        nodes_[node].position = target;
+    }
+    parents_.resize(count);
+    for (uint32_t position = 0; position < count; position++) {
+        NodeID parent = nodes_[node_ids[position]].parent;
+        parents_[position] = parent == invalid_node ? invalid_position : nodes_[parent].position;
+    }
+
+    node_ids_ = std::move(node_ids);
+    locations_ = std::move(locations);
+    rotations_ = std::move(rotations);
+    scales_ = std::move(scales);
+    world_matrices_ = std::move(world_matrices);
+    dirty_ = std::move(dirty);
+    order_dirty_ = false;
+    hole_count_ = 0;
+}
+
+glm::mat4 TransformHierarchy::composeMatrix(const glm::vec3& location, const glm::vec3& rotation, const glm::vec3& scale) {
+    auto matrix = glm::eulerAngleYXZ(glm::radians(rotation.y), glm::radians(rotation.x), glm::radians(rotation.z));
+    matrix[0] *= scale.x;
+    matrix[1] *= scale.y;
+    matrix[2] *= scale.z;
+    matrix[3] = glm::vec4(location, 1.0f);
+    return matrix;
+}
+
+}  // namespace wen
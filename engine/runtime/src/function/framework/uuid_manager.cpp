@@ -1,4 +1,6 @@
 #include "function/framework/uuid_manager.hpp"
+#include <mutex>
+#include <shared_mutex>
 
 namespace wen {
 
@@ -11,19 +13,43 @@ GameObjectUUID GameObjectUUIDAllocator::allocate() {
     return current_uuid_;
 }
 
-ComponentTypeUUIDSystem::ComponentTypeUUIDSystem() { current_uuid_ = 0; }
+namespace {
+
+struct ComponentTypeRegistry {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, ComponentTypeUUID> uuid_map;
+    ComponentTypeUUID current_uuid = 0;
+};
+
+ComponentTypeRegistry& registry() {
+    static ComponentTypeRegistry instance;
+    return instance;
+}
+
+}  // namespace
+
+ComponentTypeUUIDSystem::ComponentTypeUUIDSystem() {}
 
 ComponentTypeUUIDSystem::~ComponentTypeUUIDSystem() {}
 
 ComponentTypeUUID ComponentTypeUUIDSystem::get(const std::string& class_name) {
-    auto iter = uuid_map_.find(class_name);
-    if (iter != uuid_map_.end()) {
-        return iter->second;
-    } else {
-        current_uuid_++;
-        uuid_map_[class_name] = current_uuid_;
-        return current_uuid_;
+    return registerClass(class_name);
+}
+
+ComponentTypeUUID ComponentTypeUUIDSystem::registerClass(const std::string& class_name) {
+    auto& reg = registry();
+    {
+        std::shared_lock<std::shared_mutex> lock(reg.mutex);
+        if (auto iter = reg.uuid_map.find(class_name); iter != reg.uuid_map.end()) {
+            return iter->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(reg.mutex);
+    auto [iter, inserted] = reg.uuid_map.insert({class_name, reg.current_uuid + 1});
+    if (inserted) {
+        reg.current_uuid++;
     }
+    return iter->second;
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -0,0 +1,172 @@
+#include "function/framework/world_partition.hpp"
+#include "function/framework/scene_manager.hpp"
+#include "engine/global_context.hpp"
+
+namespace wen {
+
+WorldPartition::WorldPartition(Scene& scene, const Settings& settings) : scene_(scene), settings_(settings) {
+    loader_thread_ = std::thread([this]() { loaderLoop(); });
+}
+
+WorldPartition::~WorldPartition() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        requests_.clear();
+    }
+    condition_.notify_one();
+    loader_thread_.join();
+}
+
+void WorldPartition::addCell(CellCoord coord, CellLoader loader) {
+    auto& cell = cells_[coord];
+    if (cell != nullptr) {
+        WEN_CORE_ERROR("cell ({}, {}) already exists.", coord.x, coord.z)
+        return;
+    }
+    cell = std::make_unique<Cell>();
+    cell->coord = coord;
+    cell->loader = std::move(loader);
+    cell->buffer.markBackground();
+}
+
+CellCoord WorldPartition::getCellCoord(const glm::vec3& position) const {
+    return {static_cast<int32_t>(std::floor(position.x / settings_.cell_size)), static_cast<int32_t>(std::floor(position.z / settings_.cell_size))};
+}
+
+bool WorldPartition::isCellResident(CellCoord coord) const {
+    auto iter = cells_.find(coord);
+    return iter != cells_.end() && iter->second->state == CellState::eResident;
+}
+
+float WorldPartition::getDistance(const Cell& cell, const glm::vec3& focus) const {
+    glm::vec2 min = glm::vec2(cell.coord.x, cell.coord.z) * settings_.cell_size;
+    glm::vec2 point(focus.x, focus.z);
+    return glm::length(glm::max(glm::max(min - point, point - (min + settings_.cell_size)), glm::vec2(0.0f)));
+}
+
+void WorldPartition::update(const glm::vec3& focus) {
+    WEN_PROFILE_SCOPE("WorldPartition::update")
+    // 卸载超出范围的单元格，收集加载完成的单元格
+    std::vector<Cell*> ready_cells;
+    for (size_t i = 0; i < active_cells_.size();) {
+        auto& cell = *active_cells_[i];
+        cell.distance = getDistance(cell, focus);
+        bool out_of_range = cell.distance > settings_.unload_distance;
+        if (cell.state == CellState::eLoading) {
+            if (!cell.loaded.load(std::memory_order_acquire)) {
+                cell.cancelled = out_of_range;
+                i++;
+                continue;
+            }
+            loading_cell_count_--;
+            cell.state = cell.cancelled ? CellState::eUnloaded : CellState::eReady;
+        }
+        if (out_of_range && cell.state != CellState::eUnloaded) {
+            unloadCell(cell);
+        }
+        if (cell.state == CellState::eUnloaded) {
+            cell.buffer.clear();
+            active_cells_[i] = active_cells_.back();
+            active_cells_.pop_back();
+            continue;
+        }
+        if (cell.state == CellState::eReady) {
+            ready_cells.push_back(&cell);
+        }
+        i++;
+    }
+
+    // 由近到远开始加载进入范围的单元格
+    if (loading_cell_count_ < settings_.max_loading_cells) {
+        std::vector<Cell*> candidates;
+        auto range = glm::vec3(settings_.load_distance);
+        auto min = getCellCoord(focus - range);
+        auto max = getCellCoord(focus + range);
+        for (int32_t x = min.x; x <= max.x; x++) {
+            for (int32_t z = min.z; z <= max.z; z++) {
+                auto iter = cells_.find({x, z});
+                if (iter == cells_.end() || iter->second->state != CellState::eUnloaded) {
+                    continue;
+                }
+                auto& cell = *iter->second;
+                cell.distance = getDistance(cell, focus);
+                if (cell.distance <= settings_.load_distance) {
+                    candidates.push_back(&cell);
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Cell* lhs, const Cell* rhs) { return lhs->distance < rhs->distance; });
+        auto count = std::min<size_t>(candidates.size(), settings_.max_loading_cells - loading_cell_count_);
+        if (count > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < count; i++) {
+                auto& cell = *candidates[i];
+                cell.state = CellState::eLoading;
+                cell.cancelled = false;
+                cell.loaded.store(false, std::memory_order_relaxed);
+                active_cells_.push_back(&cell);
+                requests_.push_back(&cell);
+                loading_cell_count_++;
+            }
+        }
+        condition_.notify_one();
+    }
+
+    // 由近到远提交，超出时间预算后留到下一帧
+    std::sort(ready_cells.begin(), ready_cells.end(), [](const Cell* lhs, const Cell* rhs) { return lhs->distance < rhs->distance; });
+    auto begin = std::chrono::steady_clock::now();
+    for (auto* cell : ready_cells) {
+        commitCell(*cell);
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        if (elapsed.count() >= settings_.commit_budget_ms) {
+            break;
+        }
+    }
+}
+
+void WorldPartition::commitCell(Cell& cell) {
+    WEN_PROFILE_SCOPE("WorldPartition::commitCell")
+    cell.game_objects.clear();
+    scene_.playbackCommandBuffer(cell.buffer, &cell.game_objects);
+    scene_.startGameObjects(cell.game_objects);
+    cell.state = CellState::eResident;
+    resident_cell_count_++;
+}
+
+void WorldPartition::unloadCell(Cell& cell) {
+    if (cell.state == CellState::eResident) {
+        // 已经被其他逻辑销毁的对象直接跳过
+        for (auto handle : cell.game_objects) {
+            if (auto* game_object = scene_.getGameObject(handle); game_object != nullptr) {
+                scene_.removeGameObject(game_object);
+            }
+        }
+        cell.game_objects.clear();
+        resident_cell_count_--;
+    }
+    cell.state = CellState::eUnloaded;
+}
+
+void WorldPartition::loaderLoop() {
+    WEN_PROFILE_THREAD("World Partition Loader")
+    while (true) {
+        Cell* cell = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stop_ || !requests_.empty(); });
+            if (stop_) {
+                return;
+            }
+            cell = requests_.front();
+            requests_.pop_front();
+        }
+        {
+            WEN_PROFILE_SCOPE("WorldPartition::loadCell")
+            cell->loader(cell->buffer);
+        }
+        cell->loaded.store(true, std::memory_order_release);
+    }
+}
+
+}  // namespace wen
@@ -1,6 +1,7 @@
 #include "function/render/interface/basic/basic.hpp"
 #include "function/render/interface/basic/utils.hpp"
 #include "function/render/interface/context.hpp"
+#include "function/render/interface/resource/image.hpp"
 #include "core/base/macro.hpp"
 
 namespace wen::Renderer {
@@ -46,7 +47,8 @@ Device::Device() {
         .setMultiDrawIndirect(true)
         .setGeometryShader(true)
         .setFillModeNonSolid(true)
-        .setWideLines(true);
+        .setWideLines(true)
+        .setPipelineStatisticsQuery(renderer_config.enable_pipeline_statistics && physical_device.getFeatures().pipelineStatisticsQuery);
     device_ci.setPEnabledFeatures(&features);
     vk::PhysicalDeviceVulkan12Features features12;
     features12.setRuntimeDescriptorArray(true)
@@ -58,9 +60,11 @@ Device::Device() {
     device_ci.setPNext(&features12);
 
     std::map<std::string, bool> requiredExtensions = {
-        {VK_KHR_SWAPCHAIN_EXTENSION_NAME, false},
         {VK_KHR_BIND_MEMORY_2_EXTENSION_NAME, false},
     };
+    if (!renderer_config.headless) {
+        requiredExtensions.insert(std::make_pair(VK_KHR_SWAPCHAIN_EXTENSION_NAME, false));
+    }
 
     vk::PhysicalDeviceAccelerationStructureFeaturesKHR acceleration_structure_features = {};
     vk::PhysicalDeviceRayTracingPipelineFeaturesKHR ray_tracing_pipeline_features = {};
@@ -158,7 +162,8 @@ bool Device::suitable(const vk::PhysicalDevice& candidate) {
     auto properties = candidate.getProperties();
 
     std::string device_name = properties.deviceName;
-    if (properties.deviceType != vk::PhysicalDeviceType::eDiscreteGpu) {
+    // 离屏模式允许集成显卡和软件实现（如 lavapipe）
+    if (properties.deviceType != vk::PhysicalDeviceType::eDiscreteGpu && !renderer_config.headless) {
         WEN_CORE_ERROR("PhysicalDevice: {} not a discrete GPU", device_name)
         return false;
     }
@@ -167,7 +172,7 @@ bool Device::suitable(const vk::PhysicalDevice& candidate) {
     auto qfproperties = candidate.getQueueFamilyProperties();
     auto flags = vk::QueueFlagBits::eGraphics|vk::QueueFlagBits::eTransfer|vk::QueueFlagBits::eCompute;
     for (uint32_t i = 0; i < qfproperties.size(); i++) {
-        auto present_support = candidate.getSurfaceSupportKHR(i, manager->surface);
+        auto present_support = renderer_config.headless || candidate.getSurfaceSupportKHR(i, manager->surface);
         if (qfproperties[i].queueFlags & flags && present_support) {
             graphics_queue_family = i;
             present_queue_family = i;
@@ -187,6 +192,11 @@ bool Device::suitable(const vk::PhysicalDevice& candidate) {
 }
 
 Swapchain::Swapchain() {
+    if (renderer_config.headless) {
+        createOffscreenImages();
+        return;
+    }
+
     vk::SwapchainKHR old_swapchain = swapchain;
 
     SwapchainSupportDetails details = {
@@ -286,9 +296,33 @@ Swapchain::~Swapchain() {
         manager->device->device.destroyImageView(image_view);
     }
     image_views.clear();
+    if (renderer_config.headless) {
+        images.clear();
+        offscreen_images_.clear();
+        return;
+    }
     manager->device->device.destroySwapchainKHR(swapchain);
 }
 
+void Swapchain::createOffscreenImages() {
+    format = vk::SurfaceFormatKHR{vk::Format::eR8G8B8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear};
+    mode = vk::PresentModeKHR::eImmediate;
+    image_count = renderer_config.max_frames_in_flight;
+    for (uint32_t i = 0; i < image_count; i++) {
+        auto& image = offscreen_images_.emplace_back(std::make_unique<Image>(
+            renderer_config.swapchain_image_width,
+            renderer_config.swapchain_image_height,
+            format.format,
+            vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+            vk::SampleCountFlagBits::e1,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT
+        ));
+        images.push_back(image->image);
+        image_views.push_back(createImageView(image->image, format.format, vk::ImageAspectFlagBits::eColor, 1));
+    }
+}
+
 CommandPool::CommandPool(vk::CommandPoolCreateFlags flags) {
     vk::CommandPoolCreateInfo create_info;
     create_info.setFlags(flags)
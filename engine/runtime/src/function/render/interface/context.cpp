@@ -25,21 +25,26 @@ void Context::initialize() {
         auto vkGetInstanceProcAddr = dl.getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr");
         dispatcher = vk::detail::DispatchLoaderDynamic(instance, vkGetInstanceProcAddr);
     }
-    createSurface();
+    if (!renderer_config.headless) {
+        createSurface();
+    }
     device = std::make_unique<Device>();
+    // 离屏模式下 swapchain 的图像由 VMA 分配，因此需要先创建分配器
+    createVmaAllocator();
     swapchain = std::make_unique<Swapchain>();
     command_pool = std::make_unique<CommandPool>(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
     descriptor_pool = std::make_unique<DescriptorPool>();
-    createVmaAllocator();
 }
 
 void Context::destroy() {
-    vmaDestroyAllocator(vma_allocator);
     descriptor_pool.reset();
     command_pool.reset();
     swapchain.reset();
+    vmaDestroyAllocator(vma_allocator);
     device.reset();
-    instance.destroySurfaceKHR(surface);
+    if (surface) {
+        instance.destroySurfaceKHR(surface);
+    }
     instance.destroy();
 }
 
@@ -55,10 +60,12 @@ void Context::createInstance() {
     ins_ci.setPApplicationInfo(&app_info);
 
     std::map<std::string, bool> requiredExtensions;
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-    for (uint32_t i = 0; i < glfwExtensionCount; i++) {
-        requiredExtensions.insert(std::make_pair(static_cast<std::string>(glfwExtensions[i]), false));
+    if (!renderer_config.headless) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        for (uint32_t i = 0; i < glfwExtensionCount; i++) {
+            requiredExtensions.insert(std::make_pair(static_cast<std::string>(glfwExtensions[i]), false));
+        }
     }
 
     std::vector<const char*> extensions;
@@ -111,10 +118,16 @@ void Context::createVmaAllocator() {
 }
 
 void Context::recreateSwapchain() {
+    if (renderer_config.headless) {
+        return;
+    }
+    // 渲染线程上不能处理窗口事件，窗口最小化时等待主线程更新尺寸
     int width = 0, height = 0;
-    while (width == 0 || height == 0) {
-        glfwGetFramebufferSize(global_context->window_system->getRuntimeWindow()->getWindow(), &width, &height);
-        glfwWaitEvents();
+    auto* window = global_context->window_system->getRuntimeWindow();
+    window->getFramebufferSize(width, height);
+    while ((width == 0 || height == 0) && !window->shouldClose()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        window->getFramebufferSize(width, height);
     }
     device->device.waitIdle();
     swapchain.reset();
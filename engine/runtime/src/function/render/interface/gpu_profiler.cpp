@@ -0,0 +1,193 @@
+#include "function/render/interface/gpu_profiler.hpp"
+#include "function/render/interface/context.hpp"
+#include "core/base/macro.hpp"
+
+namespace wen::Renderer {
+
+// 统计结果按标志位从低到高排列
+static const vk::QueryPipelineStatisticFlags statistics_flags =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+static constexpr std::array<const char*, 5> statistics_suffixes = {
+    "/input assembly vertices",
+    "/vertex shader invocations",
+    "/clipping primitives",
+    "/fragment shader invocations",
+    "/compute shader invocations",
+};
+
+GpuProfiler::GpuProfiler(uint32_t max_scope_count) : max_scope_count_(max_scope_count) {
+    current_ = nullptr;
+    frame_scope_ = invalid_scope;
+    depth_ = 0;
+    statistics_active_ = false;
+    track_ = nullptr;
+
+    auto& device = manager->device;
+    auto properties = device->physical_device.getProperties();
+    auto queue_families = device->physical_device.getQueueFamilyProperties();
+    uint32_t valid_bits = queue_families[device->graphics_queue_family].timestampValidBits;
+    supported_ = valid_bits > 0 && properties.limits.timestampPeriod > 0;
+    pipeline_statistics_ = supported_ && renderer_config.enable_pipeline_statistics && device->physical_device.getFeatures().pipelineStatisticsQuery;
+    timestamp_period_ = properties.limits.timestampPeriod;
+    timestamp_mask_ = valid_bits >= 64 ? std::numeric_limits<uint64_t>::max() : (1ull << valid_bits) - 1;
+    if (!supported_) {
+        WEN_CORE_WARN("GPU timestamp query is not supported, GPU profiling disabled")
+        return;
+    }
+
+    track_ = ProfileThreadBuffer::create("GPU");
+    frames_.resize(renderer_config.max_frames_in_flight);
+    for (auto& frame : frames_) {
+        vk::QueryPoolCreateInfo timestamp_ci;
+        timestamp_ci.setQueryType(vk::QueryType::eTimestamp)
+            .setQueryCount(max_scope_count_ * 2);
+        frame.timestamp_pool = device->device.createQueryPool(timestamp_ci);
+        if (pipeline_statistics_) {
+            vk::QueryPoolCreateInfo statistics_ci;
+            statistics_ci.setQueryType(vk::QueryType::ePipelineStatistics)
+                .setQueryCount(max_scope_count_)
+                .setPipelineStatistics(statistics_flags);
+            frame.statistics_pool = device->device.createQueryPool(statistics_ci);
+        }
+        frame.scopes.reserve(max_scope_count_);
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (auto& frame : frames_) {
+        manager->device->device.destroyQueryPool(frame.timestamp_pool);
+        if (frame.statistics_pool) {
+            manager->device->device.destroyQueryPool(frame.statistics_pool);
+        }
+    }
+    frames_.clear();
+    statistics_names_.clear();
+}
+
+void GpuProfiler::beginFrame(vk::CommandBuffer cmd, uint32_t frame) {
+    if (!supported_) {
+        return;
+    }
+    current_ = &frames_[frame];
+    // 调用前已经等待过该帧的 fence，结果一定可用
+    if (current_->pending) {
+        readback(*current_);
+    }
+    cmd.resetQueryPool(current_->timestamp_pool, 0, max_scope_count_ * 2);
+    if (pipeline_statistics_) {
+        cmd.resetQueryPool(current_->statistics_pool, 0, max_scope_count_);
+    }
+    current_->scopes.clear();
+    current_->timestamp_count = 0;
+    current_->statistics_count = 0;
+    depth_ = 0;
+    statistics_active_ = false;
+    frame_scope_ = beginScope(cmd, "GPU Frame");
+}
+
+void GpuProfiler::endFrame(vk::CommandBuffer cmd) {
+    if (current_ == nullptr) {
+        return;
+    }
+    endScope(cmd, frame_scope_);
+    current_->submit_cpu_ns = ProfileThreadBuffer::now();
+    current_->pending = true;
+    current_ = nullptr;
+}
+
+uint32_t GpuProfiler::beginScope(vk::CommandBuffer cmd, const char* name, bool pipeline_statistics) {
+    if (current_ == nullptr || current_->scopes.size() >= max_scope_count_) {
+        return invalid_scope;
+    }
+    Scope scope{
+        .name = name,
+        .depth = depth_,
+        .begin_query = current_->timestamp_count++,
+        .end_query = invalid_scope,
+        .statistics_query = -1,
+    };
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, current_->timestamp_pool, scope.begin_query);
+    if (pipeline_statistics && pipeline_statistics_ && !statistics_active_) {
+        scope.statistics_query = static_cast<int32_t>(current_->statistics_count++);
+        cmd.beginQuery(current_->statistics_pool, scope.statistics_query, {});
+        statistics_active_ = true;
+    }
+    depth_++;
+    current_->scopes.push_back(scope);
+    return static_cast<uint32_t>(current_->scopes.size() - 1);
+}
+
+void GpuProfiler::endScope(vk::CommandBuffer cmd, uint32_t scope) {
+    if (current_ == nullptr || scope >= current_->scopes.size()) {
+        return;
+    }
+    auto& record = current_->scopes[scope];
+    if (record.statistics_query >= 0) {
+        cmd.endQuery(current_->statistics_pool, record.statistics_query);
+        statistics_active_ = false;
+    }
+    record.end_query = current_->timestamp_count++;
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, current_->timestamp_pool, record.end_query);
+    depth_--;
+}
+
+void GpuProfiler::readback(FrameQueries& frame) {
+    frame.pending = false;
+    if (frame.timestamp_count == 0) {
+        return;
+    }
+    auto& device = manager->device->device;
+    std::vector<uint64_t> timestamps(frame.timestamp_count);
+    auto result = device.getQueryPoolResults(frame.timestamp_pool, 0, frame.timestamp_count, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+        return;
+    }
+    constexpr uint32_t statistics_count = statistics_suffixes.size();
+    std::vector<uint64_t> statistics(frame.statistics_count * statistics_count);
+    bool has_statistics = false;
+    if (frame.statistics_count > 0) {
+        result = device.getQueryPoolResults(frame.statistics_pool, 0, frame.statistics_count, statistics.size() * sizeof(uint64_t), statistics.data(), statistics_count * sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+        has_statistics = result == vk::Result::eSuccess;
+    }
+
+    // GPU 时钟与 CPU 时钟没有校准，以提交时刻作为这一帧 GPU 时间的起点
+    uint64_t origin = timestamps[frame.scopes.front().begin_query];
+    auto toCpuTime = [&](uint64_t timestamp) {
+        return frame.submit_cpu_ns + static_cast<uint64_t>(((timestamp - origin) & timestamp_mask_) * static_cast<double>(timestamp_period_));
+    };
+
+    // 作用域按开始顺序记录，父作用域总在子作用域之前
+    uint64_t path_stack[ProfileThreadBuffer::max_depth] = {};
+    for (const auto& scope : frame.scopes) {
+        if (scope.end_query == invalid_scope || scope.depth >= ProfileThreadBuffer::max_depth) {
+            continue;
+        }
+        uint64_t begin_ns = toCpuTime(timestamps[scope.begin_query]);
+        uint64_t parent = scope.depth == 0 ? 0 : path_stack[scope.depth - 1];
+        path_stack[scope.depth] = track_->recordScope(scope.name, scope.depth, parent, begin_ns, toCpuTime(timestamps[scope.end_query]));
+        if (has_statistics && scope.statistics_query >= 0) {
+            const auto& names = getStatisticsNames(scope.name);
+            for (uint32_t i = 0; i < statistics_count; i++) {
+                track_->recordCounter(names[i], static_cast<double>(statistics[scope.statistics_query * statistics_count + i]), begin_ns);
+            }
+        }
+    }
+}
+
+const std::array<const char*, 5>& GpuProfiler::getStatisticsNames(const char* name) {
+    auto iter = statistics_names_.find(name);
+    if (iter == statistics_names_.end()) {
+        std::array<const char*, 5> names;
+        for (uint32_t i = 0; i < names.size(); i++) {
+            names[i] = ProfileSystem::internName(std::string(name) + statistics_suffixes[i]);
+        }
+        iter = statistics_names_.insert({name, names}).first;
+    }
+    return iter->second;
+}
+
+}  // namespace wen::Renderer
@@ -26,10 +26,17 @@ Renderer::Renderer(std::shared_ptr<RenderPass> render_pass) {
         in_flight_fences_[i] = manager->device->device.createFence(fence);
         in_flight_submit_infos_.emplace_back();
     }
+
+#if defined(WEN_ENABLE_PROFILER)
+    if (renderer_config.enable_gpu_profiler) {
+        gpu_profiler_ = std::make_unique<GpuProfiler>();
+    }
+#endif
 }
 
 Renderer::~Renderer() {
     waitIdle();
+    gpu_profiler_.reset();
     callbacks_.clear();
     for (uint32_t i = 0; i < renderer_config.max_frames_in_flight; i++) {
         manager->device->device.destroySemaphore(image_available_semaphores_[i]);
@@ -70,14 +77,19 @@ void Renderer::acquireNextImage() {
         WEN_CORE_ERROR("Failed to wait for fence")
     }
 
-    try {
-        if (device.acquireNextImageKHR(manager->swapchain->swapchain, std::numeric_limits<uint64_t>::max(), image_available_semaphores_[current_frame_], nullptr, &index_) == vk::Result::eErrorOutOfDateKHR) {
+    if (renderer_config.headless) {
+        // 离屏图像与 frame in flight 一一对应，fence 已保证其不再被使用
+        index_ = current_frame_;
+    } else {
+        try {
+            if (device.acquireNextImageKHR(manager->swapchain->swapchain, std::numeric_limits<uint64_t>::max(), image_available_semaphores_[current_frame_], nullptr, &index_) == vk::Result::eErrorOutOfDateKHR) {
+                updateSwapchain();
+                return;
+            }
+        } catch (vk::OutOfDateKHRError) {
             updateSwapchain();
             return;
         }
-    } catch (vk::OutOfDateKHRError) {
-        updateSwapchain();
-        return;
     }
 
     device.resetFences(in_flight_fences_[current_frame_]);
@@ -85,6 +97,9 @@ void Renderer::acquireNextImage() {
     current_subpass_ = 0;
     current_buffer_.reset();
     current_buffer_.begin(vk::CommandBufferBeginInfo{});
+    if (gpu_profiler_ != nullptr) {
+        gpu_profiler_->beginFrame(current_buffer_, current_frame_);
+    }
 }
 
 void Renderer::beginRenderPass() {
@@ -116,8 +131,19 @@ void Renderer::endRenderPass() {
 }
 
 void Renderer::present() {
+    if (gpu_profiler_ != nullptr) {
+        gpu_profiler_->endFrame(current_buffer_);
+    }
     current_buffer_.end();
 
+    if (renderer_config.headless) {
+        auto& submits = in_flight_submit_infos_[current_frame_].emplace_back();
+        submits.setCommandBuffers(current_buffer_);
+        manager->device->graphics_queue.submit(submits, in_flight_fences_[current_frame_]);
+        nextFrame();
+        return;
+    }
+
     std::vector<vk::Semaphore> wait_semaphores = {
         image_available_semaphores_[current_frame_],
     };
@@ -147,6 +173,10 @@ void Renderer::present() {
         updateSwapchain();
     }
 
+    nextFrame();
+}
+
+void Renderer::nextFrame() {
     current_frame_ = (current_frame_ + 1) % renderer_config.max_frames_in_flight;
     renderer_config.current_frame_in_flight = current_frame_;
     current_buffer_ = command_buffers_[current_frame_];
@@ -250,6 +280,10 @@ void Renderer::drawMesh(const std::shared_ptr<Mesh>& mesh, uint32_t instance_cou
 }
 
 void Renderer::traceRays(const std::shared_ptr<RayTracingRenderPipeline>& render_pipeline, uint32_t width, uint32_t height, uint32_t depth) {
+    uint32_t gpu_scope = GpuProfiler::invalid_scope;
+    if (gpu_profiler_ != nullptr) {
+        gpu_scope = gpu_profiler_->beginScope(current_buffer_, "Renderer::traceRays");
+    }
     current_buffer_.traceRaysKHR(
         render_pipeline->raygen_region_,
         render_pipeline->miss_region_,
@@ -258,6 +292,22 @@ void Renderer::traceRays(const std::shared_ptr<RayTracingRenderPipeline>& render
         width, height, depth,
         manager->dispatcher
     );
+    if (gpu_profiler_ != nullptr) {
+        gpu_profiler_->endScope(current_buffer_, gpu_scope);
+    }
+}
+
+uint32_t Renderer::beginGpuScope(const char* name, bool pipeline_statistics) {
+    if (gpu_profiler_ == nullptr) {
+        return GpuProfiler::invalid_scope;
+    }
+    return gpu_profiler_->beginScope(current_buffer_, name, pipeline_statistics);
+}
+
+void Renderer::endGpuScope(uint32_t scope) {
+    if (gpu_profiler_ != nullptr) {
+        gpu_profiler_->endScope(current_buffer_, scope);
+    }
 }
 
 void Renderer::nextSubpass() {
@@ -1,5 +1,6 @@
 #include "function/render/interface/resource/descriptor_set.hpp"
 #include "function/render/interface/context.hpp"
+#include "engine/global_context.hpp"
 #include <tiny_obj_loader.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
@@ -486,4 +487,10 @@ void SphereModel::update(uint32_t id, FunUpdateCustomData<SphereData> callback)
     as_->build(true, true);
 }
 
+void parallelUpdate(uint32_t offset, uint32_t end, uint32_t grain_size, const std::function<void(uint32_t, uint32_t, uint32_t)>& update) {
+    global_context->job_system->parallelFor(offset, end, grain_size, [&](uint32_t batch_begin, uint32_t batch_end) {
+        update(batch_begin - offset, batch_begin, batch_end);
+    });
+}
+
 }  // namespace wen::Renderer
\ No newline at end of file
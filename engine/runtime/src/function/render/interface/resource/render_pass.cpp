@@ -173,12 +173,14 @@ void RenderPass::addAttachment(const std::string& name, AttachmentType type) {
     }
 
     // Ensure the swapchain color attachment resolves to PRESENT so queue present is valid.
+    // Headless targets are never presented, keep them ready for readback instead.
     if (name == SWAPCHAIN_IMAGE_ATTACHMENT) {
+        auto final_layout = renderer_config.headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
         if (renderer_config.msaa()) {
             // With MSAA we store swapchain resolve at index 0.
-            resolve_attachments.back().attachment.setFinalLayout(vk::ImageLayout::ePresentSrcKHR);
+            resolve_attachments.back().attachment.setFinalLayout(final_layout);
         } else {
-            attachments.back().attachment.setFinalLayout(vk::ImageLayout::ePresentSrcKHR);
+            attachments.back().attachment.setFinalLayout(final_layout);
         }
     }
 }
@@ -1,8 +1,13 @@
 #include "function/render/mesh/mesh_instance_pool.hpp"
+#include "core/base/macro.hpp"
 
 namespace wen {
 
 MeshInstancePool::MeshInstancePool(uint32_t max_mesh_instance_count) {
+    current_instance_count = 0;
+    uploaded_instance_count_ = 0;
+    mesh_instances.resize(max_mesh_instance_count);
+    dirty_flags_.resize(max_mesh_instance_count, 0);
     // 网格实例数据存储在一个连续的缓冲区中，方便一次性上传到GPU
     mesh_instance_buffer = std::make_shared<Renderer::Buffer>(
         sizeof(MeshInstance) * max_mesh_instance_count,
@@ -12,26 +17,72 @@ MeshInstancePool::MeshInstancePool(uint32_t max_mesh_instance_count) {
     );
     // 将缓冲区映射到CPU地址空间，获取指向网格实例数据的指针
     mesh_instance_buffer_ptr = static_cast<MeshInstance*>(mesh_instance_buffer->map());
+    memset(mesh_instance_buffer_ptr, 0, mesh_instance_buffer->size);
 }
 
-void MeshInstancePool::createMeshInstance(const MeshInstance& mesh_instance, GameObjectUUID uuid) {
-    // 将新的网格实例数据写入缓冲区，并更新相关的映射关系
-    *mesh_instance_buffer_ptr = mesh_instance;
-    mesh_instance_buffer_ptr++;
-    current_instance_count++;
-    game_object_uuid_to_mesh_instance_index_map.insert({uuid, current_instance_count - 1});
-    mesh_instance_index_to_game_object_uuid_map.insert({current_instance_count - 1, uuid});
+uint32_t MeshInstancePool::createMeshInstance(const MeshInstance& mesh_instance) {
+    uint32_t index;
+    if (!free_instances_.empty()) {
+        index = free_instances_.back();
+        free_instances_.pop_back();
+    } else if (current_instance_count < mesh_instances.size()) {
+        index = current_instance_count++;
+    } else {
+        WEN_CORE_ERROR("mesh instance pool is full, max count: {}", mesh_instances.size())
+        return invalid_index;
+    }
+    // 写入 CPU 端的实例数据，下一次快照时上传
+    mesh_instances[index] = mesh_instance;
+    markDirty(index);
+    return index;
 }
 
-MeshInstance* MeshInstancePool::getMeshInstancePtr(GameObjectUUID uuid) {
-    return static_cast<MeshInstance*>(mesh_instance_buffer->map()) +
-           game_object_uuid_to_mesh_instance_index_map.at(uuid);
+void MeshInstancePool::destroyMeshInstance(uint32_t index) {
+    // 全零的模型矩阵使实例退化为一个点，不产生任何三角形
+    mesh_instances[index] = MeshInstance{.model = glm::mat4(0.0f), .mesh_id = 0};
+    markDirty(index);
+    free_instances_.push_back(index);
+}
+
+void MeshInstancePool::markDirty(uint32_t index) {
+    if (!dirty_flags_[index]) {
+        dirty_flags_[index] = 1;
+        dirty_instances_.push_back(index);
+    }
 }
 
 void MeshInstancePool::clear() {
-    mesh_instance_buffer_ptr = static_cast<MeshInstance*>(mesh_instance_buffer->map());
     current_instance_count = 0;
-    memset(mesh_instance_buffer_ptr, 0, mesh_instance_buffer->size);
+    free_instances_.clear();
+    std::fill(mesh_instances.begin(), mesh_instances.end(), MeshInstance{});
+    for (auto index : dirty_instances_) {
+        dirty_flags_[index] = 0;
+    }
+    dirty_instances_.clear();
+}
+
+void MeshInstancePool::collectUpdates(std::vector<MeshInstanceUpdate>& updates) {
+    updates.clear();
+    updates.reserve(dirty_instances_.size());
+    for (auto index : dirty_instances_) {
+        dirty_flags_[index] = 0;
+        if (index < current_instance_count) {
+            updates.push_back({index, mesh_instances[index]});
+        }
+    }
+    dirty_instances_.clear();
+}
+
+void MeshInstancePool::upload(uint32_t instance_count, const std::vector<MeshInstanceUpdate>& updates) {
+    // 快照按顺序提交，缓冲区中未修改的实例与 CPU 端保持一致
+    for (const auto& update : updates) {
+        mesh_instance_buffer_ptr[update.index] = update.instance;
+    }
+    // 上一帧多出来的实例需要清零
+    if (uploaded_instance_count_ > instance_count) {
+        memset(mesh_instance_buffer_ptr + instance_count, 0, sizeof(MeshInstance) * (uploaded_instance_count_ - instance_count));
+    }
+    uploaded_instance_count_ = instance_count;
 }
 
-}  // namespace wen
\ No newline at end of file
+}  // namespace wen
@@ -15,6 +15,9 @@ RenderFramework::RenderFramework() {
     // subpasses_.push_back(std::make_unique<>());
 
     for (auto& subpass : subpasses_) {
+        subpass->pre_render_pass_scope_ = ProfileSystem::internName(subpass->getName() + "::executePreRenderPass");
+        subpass->render_pass_scope_ = ProfileSystem::internName(subpass->getName() + "::executeRenderPass");
+        subpass->post_render_pass_scope_ = ProfileSystem::internName(subpass->getName() + "::executePostRenderPass");
         subpass->addAttachment(*render_pass);
     }
 
@@ -47,23 +50,44 @@ RenderFramework::~RenderFramework() {
 }
 
 void RenderFramework::render() {
-    renderer_->acquireNextImage();
-    for (auto& subpass : subpasses_) {
-        subpass->executePreRenderPass(renderer_, *resource_);
+    {
+        WEN_PROFILE_SCOPE("Renderer::acquireNextImage")
+        renderer_->acquireNextImage();
     }
-    renderer_->beginRenderPass();
-    for (auto& subpass : subpasses_) {
-        if (subpass->isOnlyCompute()) {
-            continue;
+    {
+        WEN_PROFILE_SCOPE("RenderFramework::executePreRenderPass")
+        for (auto& subpass : subpasses_) {
+            auto gpu_scope = renderer_->beginGpuScope(subpass->pre_render_pass_scope_, true);
+            subpass->executePreRenderPass(renderer_, *resource_);
+            renderer_->endGpuScope(gpu_scope);
         }
-        renderer_->nextSubpass(subpass->getName());
-        subpass->executeRenderPass(renderer_, *resource_);
     }
-    renderer_->endRenderPass();
-    for (auto& subpass : subpasses_) {
-        subpass->executePostRenderPass(renderer_, *resource_);
+    {
+        WEN_PROFILE_SCOPE("RenderFramework::executeRenderPass")
+        renderer_->beginRenderPass();
+        for (auto& subpass : subpasses_) {
+            if (subpass->isOnlyCompute()) {
+                continue;
+            }
+            renderer_->nextSubpass(subpass->getName());
+            auto gpu_scope = renderer_->beginGpuScope(subpass->render_pass_scope_, true);
+            subpass->executeRenderPass(renderer_, *resource_);
+            renderer_->endGpuScope(gpu_scope);
+        }
+        renderer_->endRenderPass();
+    }
+    {
+        WEN_PROFILE_SCOPE("RenderFramework::executePostRenderPass")
+        for (auto& subpass : subpasses_) {
+            auto gpu_scope = renderer_->beginGpuScope(subpass->post_render_pass_scope_, true);
+            subpass->executePostRenderPass(renderer_, *resource_);
+            renderer_->endGpuScope(gpu_scope);
+        }
+    }
+    {
+        WEN_PROFILE_SCOPE("Renderer::present")
+        renderer_->present();
     }
-    renderer_->present();
 }
 
 }  // namespace wen
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "function/render/render_snapshot.hpp"
+#include "core/profile/profile_system.hpp"
+
+namespace wen {
+
+RenderSnapshotQueue::RenderSnapshotQueue() {
+    for (auto& snapshot : snapshots_) {
+        free_snapshots_.push(&snapshot);
+    }
+}
+
+RenderSnapshot* RenderSnapshotQueue::acquireWritable() {
+    WEN_PROFILE_SCOPE("RenderSnapshotQueue::acquireWritable")
+    return free_snapshots_.pop();
+}
+
+void RenderSnapshotQueue::publish(RenderSnapshot* snapshot) {
+    ready_snapshots_.push(snapshot);
+}
+
+void RenderSnapshotQueue::close() {
+    ready_snapshots_.push(nullptr);
+}
+
+RenderSnapshot* RenderSnapshotQueue::acquireReadable() {
+    WEN_PROFILE_SCOPE("RenderSnapshotQueue::acquireReadable")
+    return ready_snapshots_.pop();
+}
+
+void RenderSnapshotQueue::release(RenderSnapshot* snapshot) {
+    free_snapshots_.push(snapshot);
+}
+
+}  // namespace wen
@@ -1,4 +1,5 @@
 #include "function/render/render_system.hpp"
+#include "engine/global_context.hpp"
 #include <glslang/Public/ShaderLang.h>
 
 namespace wen {
@@ -18,7 +19,19 @@ void RenderSystem::createRenderer() {
     render_data_ = std::make_unique<RenderData>();
 }
 
-void RenderSystem::render() {
+void RenderSystem::captureSnapshot(RenderSnapshot& snapshot) {
+    WEN_PROFILE_SCOPE("RenderSystem::captureSnapshot")
+    auto mesh_instance_pool = render_data_->getMeshInstancePool();
+    snapshot.mesh_instance_count = mesh_instance_pool->current_instance_count;
+    mesh_instance_pool->collectUpdates(snapshot.mesh_instance_updates);
+    snapshot.viewport_camera = global_context->camera_system->getViewportCameraData();
+    snapshot.clip_camera = global_context->camera_system->getClipCameraData();
+}
+
+void RenderSystem::render(const RenderSnapshot& snapshot) {
+    WEN_PROFILE_SCOPE("RenderSystem::render")
+    render_data_->getMeshInstancePool()->upload(snapshot.mesh_instance_count, snapshot.mesh_instance_updates);
+    global_context->camera_system->upload(snapshot.viewport_camera, snapshot.clip_camera);
     render_framework_->render();
 }
 
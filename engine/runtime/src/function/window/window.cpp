@@ -18,6 +18,19 @@ Window::Window(const WindowInfo& info) {
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
     window_ = glfwCreateWindow(static_cast<int>(w), static_cast<int>(h),
                                t.c_str(), nullptr, nullptr);
+    width_ = w;
+    height_ = h;
+
+    int framebuffer_width = 0, framebuffer_height = 0;
+    glfwGetFramebufferSize(window_, &framebuffer_width, &framebuffer_height);
+    framebuffer_width_ = framebuffer_width;
+    framebuffer_height_ = framebuffer_height;
+    glfwSetWindowUserPointer(window_, this);
+    glfwSetFramebufferSizeCallback(window_, [](GLFWwindow* glfw_window, int width, int height) {
+        auto* window = static_cast<Window*>(glfwGetWindowUserPointer(glfw_window));
+        window->framebuffer_width_ = width;
+        window->framebuffer_height_ = height;
+    });
 }
 
 Window::~Window() {
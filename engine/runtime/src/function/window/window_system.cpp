@@ -2,8 +2,8 @@
 
 namespace wen {
 
-WindowSystem::WindowSystem(const WindowInfo& info) {
-    window_ = new Window(info);
+WindowSystem::WindowSystem(const WindowInfo& info, bool headless) {
+    window_ = headless ? nullptr : new Window(info);
 }
 
 WindowSystem::~WindowSystem() {
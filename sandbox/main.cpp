@@ -3,10 +3,27 @@
 
 using namespace wen;
 
-int main() {
+int main(int argc, char** argv) {
     auto engine = std::make_unique<Engine>();
 
-    engine->startupEngine();
+    // sandbox [--headless [frame_count]] [--trace filename] [--pipeline-statistics]
+    EngineConfiguration config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            config.headless = true;
+            config.enable_ray_tracing = false;
+            if (i + 1 < argc && std::isdigit(argv[i + 1][0])) {
+                config.headless_frame_count = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            config.profile_trace_filename = argv[++i];
+        } else if (arg == "--pipeline-statistics") {
+            config.enable_pipeline_statistics = true;
+        }
+    }
+
+    engine->startupEngine(config);
 
     auto scene = global_context->scene_manager->createScene("First Scene");
     global_context->asset_system->setRootDir("sandbox/resources");
@@ -14,16 +31,14 @@ int main() {
     auto dragon_mesh_id = global_context->asset_system->loadMesh("dragon_lods.obj");
 
     auto camera = scene->createGameObject("camera");
-    camera->addComponent(new CameraControllerComponent);
-    camera->addComponent(new TransformComponent);
-    camera->addComponent(new CameraComponent);
+    camera->addComponent<CameraControllerComponent>();
+    camera->addComponent<TransformComponent>();
+    camera->addComponent<CameraComponent>();
     int n = 4, n2 = n / 2;
     for (int i = 0; i < n * n * n; i++) {
         auto dragon = scene->createGameObject("dragon");
-        auto t = new TransformComponent;
-        t->location = {i % n - n2, (i / n) % n - n2, ((i / n) / n) % n - n2};
-        dragon->addComponent(t);
-        dragon->addComponent(new MeshComponent(dragon_mesh_id));
+        dragon->addComponent<TransformComponent>()->setLocation({i % n - n2, (i / n) % n - n2, ((i / n) / n) % n - n2});
+        dragon->addComponent<MeshComponent>(dragon_mesh_id);
     }
 
     engine->runEngine();